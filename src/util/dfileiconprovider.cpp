@@ -20,9 +20,20 @@
 
 #include "dfileiconprovider.h"
 
+#include <DPlatformTheme>
+
 #include <QLibrary>
 #include <QMimeDatabase>
 #include <QMimeType>
+#include <QDateTime>
+#include <QCache>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QSharedPointer>
+#include <QPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
 #include <QDebug>
 
 #ifdef USE_GTK_PLUS_2_0
@@ -59,6 +70,9 @@ typedef char *(*Ptr_gnome_icon_lookup_sync)(
 typedef GtkIconTheme *(*Ptr_gtk_icon_theme_get_default)(void);
 #endif
 
+// 图标主题变化时递增，各 provider 据此丢弃已缓存的图标
+static QAtomicInt iconThemeGeneration;
+
 class DFileIconProviderPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
 {
 public:
@@ -68,6 +82,29 @@ public:
     QIcon getFilesystemIcon(const QFileInfo &info) const;
     QIcon fromTheme(QString iconName) const;
 
+    QString mimeTypeName(const QFileInfo &info) const;
+    QIcon mimeTypeIcon(const QString &mimeName) const;
+    void checkIconThemeGeneration() const;
+
+    struct MimeCacheEntry
+    {
+        QDateTime lastModified;
+        QString mimeName;
+    };
+
+    QMimeDatabase::MatchMode matchMode = QMimeDatabase::MatchDefault;
+    // 文件路径 -> mime 类型，文件修改时间变化后失效
+    mutable QCache<QString, MimeCacheEntry> mimeCache;
+    // mime 类型 -> 主题图标，图标主题变化后失效
+    mutable QHash<QString, QIcon> iconCache;
+    mutable int iconGeneration = 0;
+    mutable QMutex cacheMutex;
+
+    // 异步查询 mime 类型的线程，单线程执行以免并发访问慢速的挂载设备
+    mutable QThreadPool requestPool;
+    // provider 析构时置 0，用于丢弃尚未投递到主线程的结果
+    QSharedPointer<QAtomicInt> alive;
+
     D_DECLARE_PUBLIC(DFileIconProvider)
 
 #ifdef USE_GTK_PLUS_2_0
@@ -87,12 +124,27 @@ Ptr_gtk_icon_theme_get_default DFileIconProviderPrivate::gtk_icon_theme_get_defa
 
 DFileIconProviderPrivate::DFileIconProviderPrivate(DFileIconProvider *qq)
     : DObjectPrivate(qq)
+    , mimeCache(20000)
+    , alive(new QAtomicInt(1))
 {
+    requestPool.setMaxThreadCount(1);
     init();
 }
 
 void DFileIconProviderPrivate::init()
 {
+    static bool iconThemeWatched = false;
+
+    if (!iconThemeWatched && qApp) {
+        iconThemeWatched = true;
+        QObject::connect(DGUI_NAMESPACE::DGuiApplicationHelper::instance()->systemTheme(),
+                         &DGUI_NAMESPACE::DPlatformTheme::iconThemeNameChanged, qApp, [] {
+            iconThemeGeneration.ref();
+        });
+    }
+
+    iconGeneration = iconThemeGeneration.load();
+
 #ifdef USE_GTK_PLUS_2_0
     gnome_icon_lookup_sync = (Ptr_gnome_icon_lookup_sync)QLibrary::resolve(QLatin1String("gnomeui-2"), 0, "gnome_icon_lookup_sync");
     gnome_vfs_init = (Ptr_gnome_vfs_init)QLibrary::resolve(QLatin1String("gnomevfs-2"), 0, "gnome_vfs_init");
@@ -124,14 +176,69 @@ QIcon DFileIconProviderPrivate::getFilesystemIcon(const QFileInfo &info) const
     }
 #endif
 
-    const QMimeType &db = QMimeDatabase().mimeTypeForFile(info);
-    const QIcon &icon = fromTheme(db.iconName());
+    return mimeTypeIcon(mimeTypeName(info));
+}
 
-    if (!icon.isNull()) {
-        return icon;
+QString DFileIconProviderPrivate::mimeTypeName(const QFileInfo &info) const
+{
+    const QString &filePath = info.absoluteFilePath();
+    const QDateTime &lastModified = info.lastModified();
+    QMimeDatabase::MatchMode mode;
+
+    {
+        QMutexLocker locker(&cacheMutex);
+        mode = matchMode;
+
+        if (const MimeCacheEntry *entry = mimeCache.object(filePath)) {
+            if (entry->lastModified == lastModified)
+                return entry->mimeName;
+        }
     }
 
-    return fromTheme(db.genericIconName());
+    // 不持锁查询，按内容识别时可能需要读取文件
+    const QString &mimeName = QMimeDatabase().mimeTypeForFile(info, mode).name();
+
+    QMutexLocker locker(&cacheMutex);
+    mimeCache.insert(filePath, new MimeCacheEntry {lastModified, mimeName});
+
+    return mimeName;
+}
+
+QIcon DFileIconProviderPrivate::mimeTypeIcon(const QString &mimeName) const
+{
+    checkIconThemeGeneration();
+
+    {
+        QMutexLocker locker(&cacheMutex);
+        auto it = iconCache.constFind(mimeName);
+
+        if (it != iconCache.constEnd())
+            return it.value();
+    }
+
+    const QMimeType &db = QMimeDatabase().mimeTypeForName(mimeName);
+    QIcon icon = fromTheme(db.iconName());
+
+    if (icon.isNull()) {
+        icon = fromTheme(db.genericIconName());
+    }
+
+    QMutexLocker locker(&cacheMutex);
+    iconCache.insert(mimeName, icon);
+
+    return icon;
+}
+
+void DFileIconProviderPrivate::checkIconThemeGeneration() const
+{
+    const int generation = iconThemeGeneration.load();
+    QMutexLocker locker(&cacheMutex);
+
+    if (Q_LIKELY(generation == iconGeneration))
+        return;
+
+    iconCache.clear();
+    iconGeneration = generation;
 }
 
 QIcon DFileIconProviderPrivate::fromTheme(QString iconName) const
@@ -167,7 +274,10 @@ DFileIconProvider::DFileIconProvider()
 
 DFileIconProvider::~DFileIconProvider()
 {
+    Q_D(DFileIconProvider);
 
+    d->alive->store(0);
+    d->requestPool.waitForDone();
 }
 
 DFileIconProvider *DFileIconProvider::globalProvider()
@@ -193,4 +303,139 @@ QIcon DFileIconProvider::icon(const QFileInfo &info, const QIcon &feedback) cons
     return icon;
 }
 
+/*!
+ * \brief DFileIconProvider::mimeTypeMatchMode 返回查询文件 mime 类型时使用的匹配方式
+ * \sa setMimeTypeMatchMode
+ */
+QMimeDatabase::MatchMode DFileIconProvider::mimeTypeMatchMode() const
+{
+    Q_D(const DFileIconProvider);
+
+    QMutexLocker locker(&d->cacheMutex);
+    return d->matchMode;
+}
+
+/*!
+ * \brief DFileIconProvider::setMimeTypeMatchMode 设置查询文件 mime 类型时使用的匹配方式
+ * 默认为 QMimeDatabase::MatchDefault，设置为 QMimeDatabase::MatchExtension 时只根据
+ * 文件后缀判断类型，不再读取文件内容，适用于大目录或网络挂载目录中的快速列举。
+ * 修改匹配方式会清空已缓存的 mime 类型。
+ * \param mode 匹配方式
+ */
+void DFileIconProvider::setMimeTypeMatchMode(QMimeDatabase::MatchMode mode)
+{
+    Q_D(DFileIconProvider);
+
+    // 工作线程会在持有锁时读取匹配方式，这里的比较和修改也需要加锁
+    QMutexLocker locker(&d->cacheMutex);
+    if (d->matchMode == mode)
+        return;
+
+    d->matchMode = mode;
+    d->mimeCache.clear();
+}
+
+/*!
+ * \brief DFileIconProvider::clearCache 清空已缓存的文件 mime 类型和图标
+ * 图标主题变化时会自动丢弃图标缓存，文件修改时间变化时会自动重新查询其 mime 类型。
+ */
+void DFileIconProvider::clearCache()
+{
+    Q_D(DFileIconProvider);
+
+    QMutexLocker locker(&d->cacheMutex);
+    d->mimeCache.clear();
+    d->iconCache.clear();
+}
+
+/*!
+ * \brief DFileIconProvider::requestIcons 在后台线程中批量查询文件图标
+ * 文件的 mime 类型在工作线程中查询，每查询完 \a chunkSize 个文件后在主线程中解析对应的
+ * 主题图标并调用 \a callback，参数 first 为本批图标对应的第一个文件在 \a infos 中的索引。
+ * 在结果到达前可以先使用 placeholderIcon 显示占位图标。
+ * \a context 被销毁后尚未完成的查询会被取消。
+ * \param infos 要查询的文件列表
+ * \param context 回调函数的执行上下文，不能为空
+ * \param callback 每批结果就绪时在主线程中调用的函数
+ * \param chunkSize 每批结果包含的文件个数
+ * \sa placeholderIcon
+ */
+void DFileIconProvider::requestIcons(const QList<QFileInfo> &infos, QObject *context,
+                                     IconsReadyCallback callback, int chunkSize) const
+{
+    Q_D(const DFileIconProvider);
+
+    if (!context || !callback || infos.isEmpty())
+        return;
+
+    QStringList filePaths;
+    filePaths.reserve(infos.size());
+
+    // 不在工作线程中使用调用方的 QFileInfo 对象，其内部的文件信息缓存不是线程安全的
+    for (const QFileInfo &info : infos)
+        filePaths << info.absoluteFilePath();
+
+    const DFileIconProviderPrivate *dd = d;
+    QSharedPointer<QAtomicInt> alive = d->alive;
+    QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+    QPointer<QObject> receiver(context);
+
+    const QMetaObject::Connection destroyedConnection = QObject::connect(context, &QObject::destroyed, [canceled] {
+        canceled->store(1);
+    });
+
+    chunkSize = qMax(1, chunkSize);
+
+    QtConcurrent::run(&d->requestPool, [dd, filePaths, alive, canceled, receiver, callback, chunkSize, destroyedConnection] {
+        QStringList mimeNames;
+        int first = 0;
+
+        for (int i = 0; i < filePaths.size(); ++i) {
+            if (canceled->load() || !alive->load())
+                break;
+
+            mimeNames << dd->mimeTypeName(QFileInfo(filePaths.at(i)));
+
+            if (mimeNames.size() < chunkSize && i < filePaths.size() - 1)
+                continue;
+
+            // 投递到 qApp，在主线程中再检查 context 是否还存在
+            QMetaObject::invokeMethod(qApp, [dd, alive, receiver, callback, first, mimeNames] {
+                if (!receiver || !alive->load())
+                    return;
+
+                QList<QIcon> icons;
+                icons.reserve(mimeNames.size());
+
+                for (const QString &name : mimeNames)
+                    icons << dd->mimeTypeIcon(name);
+
+                callback(first, icons);
+            }, Qt::QueuedConnection);
+
+            first = i + 1;
+            mimeNames.clear();
+        }
+
+        // 查询结束后断开连接，避免长期存在的 context 上不断累积连接
+        QObject::disconnect(destroyedConnection);
+    });
+}
+
+/*!
+ * \brief DFileIconProvider::placeholderIcon 只根据文件名查询图标，不访问文件系统
+ * 用于在 requestIcons 的结果到达前显示。
+ * \param info 文件信息
+ * \return 根据文件后缀得到的图标
+ * \sa requestIcons
+ */
+QIcon DFileIconProvider::placeholderIcon(const QFileInfo &info) const
+{
+    Q_D(const DFileIconProvider);
+
+    const QMimeType &mime = QMimeDatabase().mimeTypeForFile(info.fileName(), QMimeDatabase::MatchExtension);
+
+    return d->mimeTypeIcon(mime.name());
+}
+
 DWIDGET_END_NAMESPACE
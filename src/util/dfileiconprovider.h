@@ -22,6 +22,9 @@
 #include "dtkwidget_global.h"
 
 #include <QFileIconProvider>
+#include <QMimeDatabase>
+
+#include <functional>
 
 DWIDGET_BEGIN_NAMESPACE
 
@@ -37,6 +40,16 @@ public:
     QIcon icon(const QFileInfo &info) const Q_DECL_OVERRIDE;
     QIcon icon(const QFileInfo &info, const QIcon &feedback) const;
 
+    QMimeDatabase::MatchMode mimeTypeMatchMode() const;
+    void setMimeTypeMatchMode(QMimeDatabase::MatchMode mode);
+
+    void clearCache();
+
+    typedef std::function<void(int first, const QList<QIcon> &icons)> IconsReadyCallback;
+    void requestIcons(const QList<QFileInfo> &infos, QObject *context,
+                      IconsReadyCallback callback, int chunkSize = 64) const;
+    QIcon placeholderIcon(const QFileInfo &info) const;
+
 private:
     D_DECLARE_PRIVATE(DFileIconProvider)
     Q_DISABLE_COPY(DFileIconProvider)
@@ -4,6 +4,10 @@
 #include <QImageReader>
 #include <QApplication>
 #include <QIcon>
+#include <QPixmapCache>
+#include <QHash>
+
+#define NX_FILE_CACHE_LIMIT 1024
 
 DWIDGET_BEGIN_NAMESPACE
 
@@ -24,18 +28,57 @@ QPixmap DHiDPIHelper::loadNxPixmap(const QString &fileName)
     QPixmap pixmap;
 
     if (!qFuzzyCompare(sourceDevicePixelRatio, devicePixelRatio)) {
+        // 缓存 @Nx 文件的查找结果，避免每次都去检查候选文件是否存在
+        // 与 QIcon 一样，运行期间新增或替换的资源文件不会被重新查找
+        static QHash<QString, QPair<QString, qreal>> nxFileCache;
+        const QString &nxKey = QString("%1@%2").arg(fileName).arg(devicePixelRatio);
+        auto nxFile = nxFileCache.constFind(nxKey);
+
+        if (nxFile == nxFileCache.constEnd()) {
+            // 限制缓存的大小
+            if (nxFileCache.size() >= NX_FILE_CACHE_LIMIT)
+                nxFileCache.clear();
+
+            const QString &resolvedFileName = qt_findAtNxFile(fileName, devicePixelRatio, &sourceDevicePixelRatio);
+            nxFile = nxFileCache.insert(nxKey, qMakePair(resolvedFileName, sourceDevicePixelRatio));
+        }
+
+        const QString &resolvedFileName = nxFile->first;
+        sourceDevicePixelRatio = nxFile->second;
+
+        // 同一个文件在相同缩放比下只解码一次，多个控件共享解码后的图片
+        const QString &key = QString("dtk-nx-pixmap-%1-%2").arg(resolvedFileName).arg(devicePixelRatio);
+
+        if (QPixmapCache::find(key, &pixmap))
+            return pixmap;
+
         QImageReader reader;
-        reader.setFileName(qt_findAtNxFile(fileName, devicePixelRatio, &sourceDevicePixelRatio));
+        reader.setFileName(resolvedFileName);
         if (reader.canRead()) {
             reader.setScaledSize(reader.size() * (devicePixelRatio / sourceDevicePixelRatio));
             pixmap = QPixmap::fromImage(reader.read());
             pixmap.setDevicePixelRatio(devicePixelRatio);
+            QPixmapCache::insert(key, pixmap);
         }
     } else {
+        // QPixmap::load 内部已经使用 QPixmapCache 缓存
         pixmap.load(fileName);
     }
 
     return pixmap;
 }
 
+/*!
+ * \brief DHiDPIHelper::preload decodes the suitable @Nx images ahead of time.
+ * Later loadNxPixmap calls for these files are served from QPixmapCache, so the
+ * decoded images are subject to QPixmapCache::cacheLimit.
+ * \param fileNames are the original resource file names.
+ * \sa loadNxPixmap
+ */
+void DHiDPIHelper::preload(const QStringList &fileNames)
+{
+    for (const QString &fileName : fileNames)
+        loadNxPixmap(fileName);
+}
+
 DWIDGET_END_NAMESPACE
@@ -3,12 +3,15 @@
 
 #include "dtkwidget_global.h"
 
+#include <QStringList>
+
 DWIDGET_BEGIN_NAMESPACE
 
 class DHiDPIHelper
 {
 public:
     static QPixmap loadNxPixmap(const QString &fileName);
+    static void preload(const QStringList &fileNames);
 };
 
 DWIDGET_END_NAMESPACE
@@ -42,6 +42,7 @@
 #include <private/qapplication_p.h>
 #include <private/qcoreapplication_p.h>
 #include <private/qwidget_p.h>
+#include <private/qabstractanimation_p.h>
 
 #include <DStandardPaths>
 
@@ -54,6 +55,7 @@
 #include "private/dapplication_p.h"
 #include "daboutdialog.h"
 #include "dmainwindow.h"
+#include "private/danimationclock_p.h"
 
 #include <DPlatformHandle>
 #include <DGuiApplicationHelper>
@@ -990,6 +992,31 @@ QString DApplication::customizedQtThemeConfigPath()
     return QString::fromLocal8Bit(qgetenv(QT_THEME_CONFIG_PATH));
 }
 
+/*!
+ * \~chinese \brief DApplication::setAnimationFrameRateLimit
+ * \~chinese 限制 DSpinner、DWaterProgress、DPictureSequenceView 等动画控件以及
+ * \~chinese QPropertyAnimation 等 Qt 动画的最高刷新帧率，可用于低功耗模式。
+ * \~chinese 默认不限制，动画控件按屏幕刷新率刷新。
+ * \~chinese \param fps 最高帧率，小于等于 0 时取消限制
+ * \~chinese \warning 必须在构造 DApplication 对象之后调用
+ */
+void DApplication::setAnimationFrameRateLimit(int fps)
+{
+    DAnimationClock::instance()->setMaximumFrameRate(fps);
+    // Qt 动画默认每 16 毫秒刷新一次
+    QUnifiedTimer::instance()->setTimingInterval(fps > 0 ? qMax(16, 1000 / fps) : 16);
+}
+
+/*!
+ * \~chinese \brief DApplication::animationFrameRateLimit
+ * \~chinese \return 返回动画的最高刷新帧率，未限制时返回 0。
+ * \~chinese \sa DApplication::setAnimationFrameRateLimit
+ */
+int DApplication::animationFrameRateLimit()
+{
+    return DAnimationClock::instance()->maximumFrameRate();
+}
+
 /**
  * \~english @brief DApplication::productName returns the product name of this application.
  *
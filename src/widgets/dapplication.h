@@ -87,6 +87,9 @@ public:
     static void customQtThemeConfigPath(const QString &path);
     static QString customizedQtThemeConfigPath();
 
+    static void setAnimationFrameRateLimit(int fps);
+    static int animationFrameRateLimit();
+
     // meta information that necessary to create a about dialog for the application.
     QString productName() const;
     void setProductName(const QString &productName);
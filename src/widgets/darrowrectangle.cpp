@@ -1177,32 +1177,74 @@ void DArrowRectanglePrivate::horizontalMove(int x, int y)
 
 void DArrowRectanglePrivate::updateClipPath()
 {
-    D_Q(DArrowRectangle);
-
     if (!m_handle) {
         return;
     }
 
-    QPainterPath path;
+    m_handle->setClipPath(borderPath());
+}
+
+bool DArrowRectanglePrivate::BorderPathKey::operator==(const BorderPathKey &other) const
+{
+    return size == other.size && direction == other.direction
+            && arrowX == other.arrowX && arrowY == other.arrowY
+            && arrowWidth == other.arrowWidth && arrowHeight == other.arrowHeight
+            && radius == other.radius && margin == other.margin && floatMode == other.floatMode
+            && qFuzzyCompare(shadowBlurRadius + 1, other.shadowBlurRadius + 1)
+            && qFuzzyCompare(shadowDistance + 1, other.shadowDistance + 1)
+            && hasHandle == other.hasHandle && radiusEnabled == other.radiusEnabled
+            && leftRightRadius == other.leftRightRadius && radiusArrowStyle == other.radiusArrowStyle;
+}
+
+/*!
+ * \~chinese \brief DArrowRectanglePrivate::borderPath 返回带箭头的边框路径
+ * \~chinese 绘制和设置窗口裁剪区域时共用，影响路径的参数都未改变时不再重新生成
+ */
+const QPainterPath &DArrowRectanglePrivate::borderPath()
+{
+    D_Q(DArrowRectangle);
+
+    BorderPathKey key;
+    key.size = q->size();
+    key.direction = m_arrowDirection;
+    key.arrowX = m_arrowX;
+    key.arrowY = m_arrowY;
+    key.arrowWidth = m_arrowWidth;
+    key.arrowHeight = m_arrowHeight;
+    key.radius = m_radius;
+    key.margin = m_margin;
+    key.floatMode = floatMode;
+    key.shadowBlurRadius = m_shadowBlurRadius;
+    key.shadowDistance = m_shadowDistance;
+    key.hasHandle = m_handle;
+    key.radiusEnabled = radiusEnabled();
+    key.leftRightRadius = leftRightRadius;
+    key.radiusArrowStyle = radiusArrowStyleEnable;
+
+    if (borderPathSerial > 0 && key == borderPathKey)
+        return borderPathCache;
 
     switch (m_arrowDirection) {
     case DArrowRectangle::ArrowLeft:
-        path = getLeftCornerPath();
+        borderPathCache = getLeftCornerPath();
         break;
     case DArrowRectangle::ArrowRight:
-        path = getRightCornerPath();
+        borderPathCache = getRightCornerPath();
         break;
     case DArrowRectangle::ArrowTop:
-        path = getTopCornerPath();
+        borderPathCache = getTopCornerPath();
         break;
     case DArrowRectangle::ArrowBottom:
-        path = getBottomCornerPath();
+        borderPathCache = getBottomCornerPath();
         break;
     default:
-        path = getRightCornerPath();
+        borderPathCache = getRightCornerPath();
     }
 
-    m_handle->setClipPath(path);
+    borderPathKey = key;
+    ++borderPathSerial;
+
+    return borderPathCache;
 }
 
 bool DArrowRectanglePrivate::radiusEnabled()
@@ -1387,34 +1429,36 @@ void DArrowRectanglePrivate::paintEvent(QPaintEvent *e)
     if (m_handle) {
         painter.fillRect(e->rect(), bk_color);
     } else {
-        painter.setRenderHint(QPainter::Antialiasing);
-
-        QPainterPath border;
-
-        switch (m_arrowDirection) {
-        case DArrowRectangle::ArrowLeft:
-            border = getLeftCornerPath();
-            break;
-        case DArrowRectangle::ArrowRight:
-            border = getRightCornerPath();
-            break;
-        case DArrowRectangle::ArrowTop:
-            border = getTopCornerPath();
-            break;
-        case DArrowRectangle::ArrowBottom:
-            border = getBottomCornerPath();
-            break;
-        default:
-            border = getRightCornerPath();
+        const QPainterPath &border = borderPath();
+        const qreal ratio = q->devicePixelRatioF();
+
+        // 只在边框或颜色改变时重新绘制，其它情况（如内容控件刷新）直接使用缓存的图片
+        if (borderPixmap.isNull() || borderPixmapSerial != borderPathSerial
+                || !qFuzzyCompare(borderPixmap.devicePixelRatio(), ratio)
+                || borderPixmapBackground != bk_color || borderPixmapBorderColor != m_borderColor
+                || borderPixmapBorderWidth != m_borderWidth) {
+            borderPixmap = QPixmap(q->size() * ratio);
+            borderPixmap.setDevicePixelRatio(ratio);
+            borderPixmap.fill(Qt::transparent);
+
+            QPainter pa(&borderPixmap);
+            pa.setRenderHint(QPainter::Antialiasing);
+            pa.setClipPath(border);
+            pa.fillPath(border, QBrush(bk_color));
+
+            QPen strokePen;
+            strokePen.setColor(m_borderColor);
+            strokePen.setWidth(m_borderWidth);
+            pa.strokePath(border, strokePen);
+            pa.end();
+
+            borderPixmapSerial = borderPathSerial;
+            borderPixmapBackground = bk_color;
+            borderPixmapBorderColor = m_borderColor;
+            borderPixmapBorderWidth = m_borderWidth;
         }
 
-        painter.setClipPath(border);
-        painter.fillPath(border, QBrush(bk_color));
-
-        QPen strokePen;
-        strokePen.setColor(m_borderColor);
-        strokePen.setWidth(m_borderWidth);
-        painter.strokePath(border, strokePen);
+        painter.drawPixmap(0, 0, borderPixmap);
     }
 }
 
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2021 ~ 2021 Deepin Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dflowcontainer.h"
+#include "private/dflowcontainer_p.h"
+#include "private/dflowlayout_p.h"
+
+#include <QScrollBar>
+#include <QEvent>
+
+#include <algorithm>
+
+DWIDGET_BEGIN_NAMESPACE
+
+DFlowContainerPrivate::DFlowContainerPrivate(DFlowContainer *qq)
+    : DObjectPrivate(qq)
+{
+
+}
+
+void DFlowContainerPrivate::init()
+{
+    D_Q(DFlowContainer);
+
+    q->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+}
+
+void DFlowContainerPrivate::doLayout()
+{
+    D_Q(DFlowContainer);
+
+    const int width = q->viewport()->width();
+    QVector<QSize> sizes(count);
+
+    for (int i = 0; i < count; ++i)
+        sizes[i] = sizeHintFunction ? sizeHintFunction(i) : itemSize;
+
+    // 和 DFlowLayout 使用相同的换行规则
+    const QRect rect(0, 0, width, 0);
+    const QSize &size = DFlowLayoutPrivate::horizontalFlow(rect, rect, 0, sizes, horizontalSpacing, verticalSpacing,
+                                                           q->layoutDirection(), &geometries);
+
+    lineFirstIndex.clear();
+    lineTop.clear();
+    lineBottom.clear();
+
+    for (int i = 0; i < geometries.count(); ++i) {
+        const QRect &geometry = geometries.at(i);
+
+        if (lineTop.isEmpty() || geometry.y() != lineTop.last()) {
+            lineFirstIndex << i;
+            lineTop << geometry.y();
+            lineBottom << geometry.bottom();
+        } else {
+            lineBottom.last() = qMax(lineBottom.last(), geometry.bottom());
+        }
+    }
+
+    contentHeight = count > 0 ? size.height() : 0;
+    layoutWidth = width;
+    layoutDirty = false;
+}
+
+void DFlowContainerPrivate::updateScrollBar()
+{
+    D_Q(DFlowContainer);
+
+    QScrollBar *bar = q->verticalScrollBar();
+    const int height = q->viewport()->height();
+
+    bar->setPageStep(height);
+    bar->setSingleStep(qMax(1, itemSize.height() / 2));
+    bar->setRange(0, qMax(0, contentHeight - height));
+}
+
+void DFlowContainerPrivate::updateVisibleItems()
+{
+    D_Q(DFlowContainer);
+
+    if (layoutDirty || layoutWidth != q->viewport()->width()) {
+        doLayout();
+    }
+
+    // 滚动条范围改变时可能会再次调用此函数，所以需要在更新后再获取偏移量
+    updateScrollBar();
+
+    const int offset = q->verticalScrollBar()->value();
+    const int top = offset;
+    const int bottom = offset + q->viewport()->height() - 1;
+    int first = -1;
+    int last = -2;
+
+    int firstLine = lineAt(top);
+
+    if (firstLine < lineTop.count() && lineTop.at(firstLine) <= bottom) {
+        int lastLine = int(std::upper_bound(lineTop.constBegin(), lineTop.constEnd(), bottom) - lineTop.constBegin()) - 1;
+
+        first = lineFirstIndex.at(firstLine);
+        last = (lastLine + 1 < lineFirstIndex.count() ? lineFirstIndex.at(lastLine + 1) : count) - 1;
+    }
+
+    // 回收移出可见区域的控件
+    for (auto it = visibleWidgets.begin(); it != visibleWidgets.end();) {
+        if (it.key() < first || it.key() > last) {
+            it.value()->hide();
+            recycledWidgets << it.value();
+            it = visibleWidgets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (int i = first; i <= last; ++i) {
+        QWidget *widget = visibleWidgets.value(i);
+
+        if (!widget) {
+            if (!recycledWidgets.isEmpty()) {
+                widget = recycledWidgets.takeLast();
+            } else if (createFunction) {
+                widget = createFunction(q->viewport());
+            }
+
+            if (!widget)
+                break;
+
+            if (widget->parentWidget() != q->viewport())
+                widget->setParent(q->viewport());
+
+            if (bindFunction)
+                bindFunction(widget, i);
+
+            visibleWidgets.insert(i, widget);
+        }
+
+        widget->setGeometry(geometries.at(i).translated(0, -offset));
+        widget->show();
+    }
+}
+
+void DFlowContainerPrivate::recycleAll()
+{
+    for (QWidget *widget : visibleWidgets) {
+        widget->hide();
+        recycledWidgets << widget;
+    }
+
+    visibleWidgets.clear();
+}
+
+int DFlowContainerPrivate::lineAt(int y) const
+{
+    // 每一行的底部是递增的，找到第一个底部不小于 y 的行
+    return int(std::lower_bound(lineBottom.constBegin(), lineBottom.constEnd(), y) - lineBottom.constBegin());
+}
+
+/*!
+ * \~english \class DFlowContainer
+ * \~english \brief The DFlowContainer class arranges a large number of items in flow order,
+ * \~english creating widgets only for the items visible in the viewport.
+ *
+ * \~english The geometry of every item is computed with the same line breaking rules as DFlowLayout,
+ * \~english but widgets are only created for items intersecting the viewport. Widgets scrolled out
+ * \~english of view are recycled and bound to other items, so the number of widgets stays bounded
+ * \~english no matter how many items there are.
+ *
+ * \~chinese \class DFlowContainer
+ * \~chinese \brief DFlowContainer 以流式布局排列大量的元素，只为可见区域内的元素创建控件。
+ *
+ * \~chinese 所有元素的位置都按照和 DFlowLayout 相同的换行规则计算，但只有和可见区域相交的元素
+ * \~chinese 才会拥有控件，移出可见区域的控件会被回收并绑定到其它元素上，因此无论元素有多少，
+ * \~chinese 控件的数量都是有限的。
+ *
+ * \~chinese 使用 setCreateFunction 设置创建控件的函数，使用 setBindFunction 设置将控件和元素
+ * \~chinese 绑定的函数，元素的大小可以通过 setItemSize 统一设置，或者通过 setSizeHintFunction 单独指定。
+ *
+ * \sa DFlowLayout
+ */
+
+DFlowContainer::DFlowContainer(QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , DObject(*new DFlowContainerPrivate(this))
+{
+    D_D(DFlowContainer);
+
+    d->init();
+}
+
+DFlowContainer::~DFlowContainer()
+{
+
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::count 元素的数量
+ */
+int DFlowContainer::count() const
+{
+    D_DC(DFlowContainer);
+
+    return d->count;
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::itemSize 未设置 setSizeHintFunction 时所有元素的大小
+ */
+QSize DFlowContainer::itemSize() const
+{
+    D_DC(DFlowContainer);
+
+    return d->itemSize;
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::horizontalSpacing 元素的水平间距
+ */
+int DFlowContainer::horizontalSpacing() const
+{
+    D_DC(DFlowContainer);
+
+    return d->horizontalSpacing;
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::verticalSpacing 行之间的间距
+ */
+int DFlowContainer::verticalSpacing() const
+{
+    D_DC(DFlowContainer);
+
+    return d->verticalSpacing;
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::setSizeHintFunction 设置获取每个元素大小的函数，
+ * \~chinese 为空时所有元素都使用 itemSize 的大小
+ * \~chinese \note 元素的大小改变后需要调用 relayout
+ */
+void DFlowContainer::setSizeHintFunction(SizeHintFunction function)
+{
+    D_D(DFlowContainer);
+
+    d->sizeHintFunction = function;
+    relayout();
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::setCreateFunction 设置创建元素控件的函数，
+ * \~chinese 已经创建的控件会被销毁
+ */
+void DFlowContainer::setCreateFunction(CreateFunction function)
+{
+    D_D(DFlowContainer);
+
+    d->recycleAll();
+    qDeleteAll(d->recycledWidgets);
+    d->recycledWidgets.clear();
+    d->createFunction = function;
+    d->updateVisibleItems();
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::setBindFunction 设置将控件绑定到元素的函数，
+ * \~chinese 控件被复用到其它元素时也会调用此函数
+ */
+void DFlowContainer::setBindFunction(BindFunction function)
+{
+    D_D(DFlowContainer);
+
+    d->bindFunction = function;
+    d->recycleAll();
+    d->updateVisibleItems();
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::itemRect 返回元素在内容中的位置（不包含滚动的偏移）
+ */
+QRect DFlowContainer::itemRect(int index) const
+{
+    D_DC(DFlowContainer);
+
+    if (d->layoutDirty || d->layoutWidth != viewport()->width())
+        const_cast<DFlowContainerPrivate *>(d)->doLayout();
+
+    return d->geometries.value(index);
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::indexAt 返回视口中 \a pos 位置的元素，没有元素时返回 -1
+ */
+int DFlowContainer::indexAt(const QPoint &pos) const
+{
+    D_DC(DFlowContainer);
+
+    if (d->layoutDirty || d->layoutWidth != viewport()->width())
+        const_cast<DFlowContainerPrivate *>(d)->doLayout();
+
+    const QPoint point(pos.x(), pos.y() + verticalScrollBar()->value());
+    const int line = d->lineAt(point.y());
+
+    if (line >= d->lineTop.count() || d->lineTop.at(line) > point.y())
+        return -1;
+
+    const int end = line + 1 < d->lineFirstIndex.count() ? d->lineFirstIndex.at(line + 1) : d->count;
+
+    for (int i = d->lineFirstIndex.at(line); i < end; ++i) {
+        if (d->geometries.at(i).contains(point))
+            return i;
+    }
+
+    return -1;
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::itemWidget 返回元素当前绑定的控件，元素不可见时返回空
+ */
+QWidget *DFlowContainer::itemWidget(int index) const
+{
+    D_DC(DFlowContainer);
+
+    return d->visibleWidgets.value(index);
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::setCount 设置元素的数量，所有可见的控件都会被重新绑定
+ */
+void DFlowContainer::setCount(int count)
+{
+    D_D(DFlowContainer);
+
+    count = qMax(0, count);
+
+    if (d->count == count)
+        return;
+
+    d->count = count;
+    d->layoutDirty = true;
+    d->recycleAll();
+    d->updateVisibleItems();
+
+    Q_EMIT countChanged(count);
+}
+
+void DFlowContainer::setItemSize(const QSize &size)
+{
+    D_D(DFlowContainer);
+
+    if (d->itemSize == size)
+        return;
+
+    d->itemSize = size;
+    relayout();
+}
+
+void DFlowContainer::setHorizontalSpacing(int spacing)
+{
+    D_D(DFlowContainer);
+
+    if (d->horizontalSpacing == spacing)
+        return;
+
+    d->horizontalSpacing = spacing;
+    relayout();
+}
+
+void DFlowContainer::setVerticalSpacing(int spacing)
+{
+    D_D(DFlowContainer);
+
+    if (d->verticalSpacing == spacing)
+        return;
+
+    d->verticalSpacing = spacing;
+    relayout();
+}
+
+void DFlowContainer::setSpacing(int spacing)
+{
+    setHorizontalSpacing(spacing);
+    setVerticalSpacing(spacing);
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::updateItem 元素的数据改变后重新绑定其控件
+ */
+void DFlowContainer::updateItem(int index)
+{
+    D_D(DFlowContainer);
+
+    if (QWidget *widget = d->visibleWidgets.value(index)) {
+        if (d->bindFunction)
+            d->bindFunction(widget, index);
+    }
+}
+
+/*!
+ * \~chinese \brief DFlowContainer::relayout 重新计算所有元素的位置
+ */
+void DFlowContainer::relayout()
+{
+    D_D(DFlowContainer);
+
+    d->layoutDirty = true;
+    d->updateVisibleItems();
+}
+
+bool DFlowContainer::viewportEvent(QEvent *event)
+{
+    D_D(DFlowContainer);
+
+    switch (event->type()) {
+    case QEvent::Resize:
+        d->updateVisibleItems();
+        break;
+    case QEvent::LayoutDirectionChange:
+        relayout();
+        break;
+    default:
+        break;
+    }
+
+    return QAbstractScrollArea::viewportEvent(event);
+}
+
+void DFlowContainer::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx)
+    Q_UNUSED(dy)
+    D_D(DFlowContainer);
+
+    d->updateVisibleItems();
+}
+
+DWIDGET_END_NAMESPACE
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 ~ 2021 Deepin Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DFLOWCONTAINER_H
+#define DFLOWCONTAINER_H
+
+#include <dtkwidget_global.h>
+#include <DObject>
+
+#include <QAbstractScrollArea>
+
+#include <functional>
+
+DWIDGET_BEGIN_NAMESPACE
+
+class DFlowContainerPrivate;
+class DFlowContainer : public QAbstractScrollArea, public DCORE_NAMESPACE::DObject
+{
+    Q_OBJECT
+    D_DECLARE_PRIVATE(DFlowContainer)
+
+    Q_PROPERTY(int count READ count WRITE setCount NOTIFY countChanged)
+    Q_PROPERTY(QSize itemSize READ itemSize WRITE setItemSize)
+    Q_PROPERTY(int horizontalSpacing READ horizontalSpacing WRITE setHorizontalSpacing)
+    Q_PROPERTY(int verticalSpacing READ verticalSpacing WRITE setVerticalSpacing)
+
+public:
+    typedef std::function<QSize(int index)> SizeHintFunction;
+    typedef std::function<QWidget *(QWidget *parent)> CreateFunction;
+    typedef std::function<void(QWidget *widget, int index)> BindFunction;
+
+    explicit DFlowContainer(QWidget *parent = nullptr);
+    ~DFlowContainer() override;
+
+    int count() const;
+    QSize itemSize() const;
+    int horizontalSpacing() const;
+    int verticalSpacing() const;
+
+    void setSizeHintFunction(SizeHintFunction function);
+    void setCreateFunction(CreateFunction function);
+    void setBindFunction(BindFunction function);
+
+    QRect itemRect(int index) const;
+    int indexAt(const QPoint &pos) const;
+    QWidget *itemWidget(int index) const;
+
+public Q_SLOTS:
+    void setCount(int count);
+    void setItemSize(const QSize &size);
+    void setHorizontalSpacing(int spacing);
+    void setVerticalSpacing(int spacing);
+    void setSpacing(int spacing);
+    void updateItem(int index);
+    void relayout();
+
+Q_SIGNALS:
+    void countChanged(int count);
+
+protected:
+    bool viewportEvent(QEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+};
+
+DWIDGET_END_NAMESPACE
+
+#endif // DFLOWCONTAINER_H
@@ -29,6 +29,136 @@ DFlowLayoutPrivate::DFlowLayoutPrivate(DFlowLayout *qq) :
 
 }
 
+const QVector<QSize> &DFlowLayoutPrivate::itemSizeHints() const
+{
+    if (itemSizeHintsValid)
+        return itemSizeHintCache;
+
+    itemSizeHintCache.resize(itemList.count());
+    uniformItemSize = true;
+
+    for (int i = 0; i < itemList.count(); ++i) {
+        itemSizeHintCache[i] = itemList.at(i)->sizeHint();
+
+        if (itemSizeHintCache.at(i) != itemSizeHintCache.first())
+            uniformItemSize = false;
+    }
+
+    itemSizeHintsValid = true;
+
+    return itemSizeHintCache;
+}
+
+void DFlowLayoutPrivate::clearCache()
+{
+    itemSizeHintsValid = false;
+    itemSizeHintCache.clear();
+    heightForWidthCache.clear();
+}
+
+// 所有元素大小一致时（如标签云、缩略图），无需遍历元素即可计算出布局的大小，
+// 结果和 doLayout 中逐个排列元素得到的一致
+QSize DFlowLayoutPrivate::uniformLayoutSize(const QRect &rect, const QRect &effectiveRect) const
+{
+    D_QC(DFlowLayout);
+
+    const QSize &itemSize = itemSizeHintCache.first();
+    const int step = itemSize.width() + horizontalSpacing;
+
+    // doLayout 只在行高大于 0 时换行，这种情况不做处理
+    if (step <= 0 || itemSize.height() <= 0)
+        return QSize();
+
+    int bottom;
+    q->getContentsMargins(nullptr, nullptr, nullptr, &bottom);
+
+    // 每行的第一个元素总会被放置，其余元素需要完整的放在区域内
+    const int available = effectiveRect.width() - 1 - itemSize.width();
+    const int perLine = available < 0 ? 1 : available / step + 1;
+    const int lines = (itemList.count() + perLine - 1) / perLine;
+    const int y = effectiveRect.y() + (lines - 1) * (itemSize.height() + verticalSpacing);
+    int maxWidth = 0;
+
+    if (lines > 1) {
+        maxWidth = perLine * step;
+
+        if (q->parentWidget()->layoutDirection() != Qt::RightToLeft)
+            maxWidth += effectiveRect.x();
+    }
+
+    return QSize(maxWidth, y + itemSize.height() - rect.y() + bottom);
+}
+
+/*!
+ * \~chinese \brief DFlowLayoutPrivate::horizontalFlow 按照从左到右（或从右到左）换行的方式排列 \a sizes 大小的元素
+ * \~chinese \param rect 布局的区域
+ * \~chinese \param effectiveRect 去除边距后的区域
+ * \~chinese \param bottomMargin 底部的边距
+ * \~chinese \param geometries 不为空时保存每个元素的位置
+ * \~chinese \return 布局所需的大小
+ */
+QSize DFlowLayoutPrivate::horizontalFlow(const QRect &rect, const QRect &effectiveRect, int bottomMargin,
+                                         const QVector<QSize> &sizes, int horizontalSpacing, int verticalSpacing,
+                                         Qt::LayoutDirection direction, QVector<QRect> *geometries)
+{
+    int maxWidth = 0;
+    int lineHeight = 0;
+    int y = effectiveRect.y();
+
+    if (geometries)
+        geometries->resize(sizes.count());
+
+    if(direction == Qt::RightToLeft) {
+        int x = effectiveRect.right();
+
+        for (int i = 0; i < sizes.count(); ++i) {
+            const QSize &itemSizeHint = sizes.at(i);
+            int nextX = x - itemSizeHint.width() - horizontalSpacing;
+
+            if (nextX + horizontalSpacing < effectiveRect.x() && lineHeight > 0) {
+                maxWidth = qMax(effectiveRect.right() - x, maxWidth);
+                x = effectiveRect.right();
+                y = y + lineHeight + verticalSpacing;
+                nextX = x - itemSizeHint.width() - horizontalSpacing;
+                lineHeight = 0;
+            }
+
+            if (geometries) {
+                QRect &item_geometry = (*geometries)[i];
+
+                item_geometry.setSize(itemSizeHint);
+                item_geometry.moveTopRight(QPoint(x, y));
+            }
+
+            x = nextX;
+            lineHeight = qMax(lineHeight, itemSizeHint.height());
+        }
+    } else {
+        int x = effectiveRect.x();
+
+        for (int i = 0; i < sizes.count(); ++i) {
+            const QSize &itemSizeHint = sizes.at(i);
+            int nextX = x + itemSizeHint.width() + horizontalSpacing;
+
+            if (nextX - horizontalSpacing > effectiveRect.right() && lineHeight > 0) {
+                maxWidth = qMax(x, maxWidth);
+                x = effectiveRect.x();
+                y = y + lineHeight + verticalSpacing;
+                nextX = x + itemSizeHint.width() + horizontalSpacing;
+                lineHeight = 0;
+            }
+
+            if (geometries)
+                (*geometries)[i] = QRect(QPoint(x, y), itemSizeHint);
+
+            x = nextX;
+            lineHeight = qMax(lineHeight, itemSizeHint.height());
+        }
+    }
+
+    return QSize(maxWidth, y + lineHeight - rect.y() + bottomMargin);
+}
+
 QSize DFlowLayoutPrivate::doLayout(const QRect &rect, bool testOnly) const
 {
     D_QC(DFlowLayout);
@@ -51,98 +181,72 @@ QSize DFlowLayoutPrivate::doLayout(const QRect &rect, bool testOnly) const
     int y = effectiveRect.y();
 
     QSize size_hint;
+    const QVector<QSize> &sizes = itemSizeHints();
 
-    if(flow == DFlowLayout::Flow::LeftToRight) {
-        int maxWidth = 0;
-        int lineHeight = 0;
-
-        if(q->parentWidget()->layoutDirection() == Qt::RightToLeft) {
-            for (QLayoutItem *item : itemList) {
-                int nextX = x - item->sizeHint().width() - horizontalSpacing;
-
-                if (nextX + horizontalSpacing < effectiveRect.x() && lineHeight > 0) {
-                    maxWidth = qMax(effectiveRect.right() - x, maxWidth);
-                    x = effectiveRect.right();
-                    y = y + lineHeight + verticalSpacing;
-                    nextX = x - item->sizeHint().width() - horizontalSpacing;
-                    lineHeight = 0;
-                }
-
-                if (!testOnly) {
-                    QRect item_geometry;
-
-                    item_geometry.setSize(item->sizeHint());
-                    item_geometry.moveTopRight(QPoint(x, y));
-                    item->setGeometry(item_geometry);
-                }
+    if(testOnly && flow == DFlowLayout::Flow::LeftToRight && uniformItemSize && !itemList.isEmpty()) {
+        size_hint = uniformLayoutSize(rect, effectiveRect);
 
-                x = nextX;
-                lineHeight = qMax(lineHeight, item->sizeHint().height());
-            }
-
-            size_hint = QSize(maxWidth, y + lineHeight - rect.y() + bottom);
-        } else {
-            for (QLayoutItem *item : itemList) {
-                int nextX = x + item->sizeHint().width() + horizontalSpacing;
-
-                if (nextX - horizontalSpacing > effectiveRect.right() && lineHeight > 0) {
-                    maxWidth = qMax(x, maxWidth);
-                    x = effectiveRect.x();
-                    y = y + lineHeight + verticalSpacing;
-                    nextX = x + item->sizeHint().width() + horizontalSpacing;
-                    lineHeight = 0;
-                }
+        if (size_hint.isValid())
+            return size_hint;
+    }
 
-                if (!testOnly)
-                    item->setGeometry(QRect(QPoint(x, y), item->sizeHint()));
+    if(flow == DFlowLayout::Flow::LeftToRight) {
+        QVector<QRect> geometries;
 
-                x = nextX;
-                lineHeight = qMax(lineHeight, item->sizeHint().height());
-            }
+        size_hint = horizontalFlow(rect, effectiveRect, bottom, sizes, horizontalSpacing, verticalSpacing,
+                                   q->parentWidget()->layoutDirection(), testOnly ? nullptr : &geometries);
 
-            size_hint = QSize(maxWidth, y + lineHeight - rect.y() + bottom);
+        if (!testOnly) {
+            for (int i = 0; i < itemList.count(); ++i)
+                itemList.at(i)->setGeometry(geometries.at(i));
         }
     } else {
         int maxHeight = 0;
         int lineWidth = 0;
 
         if(q->parentWidget()->layoutDirection() == Qt::RightToLeft) {
-            for (QLayoutItem *item : itemList) {
-                int nextY = y + item->sizeHint().height() + verticalSpacing;
+            for (int i = 0; i < itemList.count(); ++i) {
+                QLayoutItem *item = itemList.at(i);
+                const QSize &itemSizeHint = sizes.at(i);
+
+                int nextY = y + itemSizeHint.height() + verticalSpacing;
 
                 if(nextY - verticalSpacing > effectiveRect.bottom() && lineWidth > 0) {
                     maxHeight = qMax(y, maxHeight);
                     y = effectiveRect.y();
                     x = x - lineWidth - horizontalSpacing;
-                    nextY = y + item->sizeHint().height() + verticalSpacing;
+                    nextY = y + itemSizeHint.height() + verticalSpacing;
                     lineWidth = 0;
                 }
 
                 if (!testOnly)
-                    item->setGeometry(QRect(QPoint(x - item->sizeHint().width(), y), item->sizeHint()));
+                    item->setGeometry(QRect(QPoint(x - itemSizeHint.width(), y), itemSizeHint));
 
                 y = nextY;
-                lineWidth = qMax(lineWidth, item->sizeHint().width());
+                lineWidth = qMax(lineWidth, itemSizeHint.width());
             }
 
             size_hint = QSize(rect.right() - x + lineWidth + right + 1, maxHeight);
         } else {
-            for (QLayoutItem *item : itemList) {
-                int nextY = y + item->sizeHint().height() + verticalSpacing;
+            for (int i = 0; i < itemList.count(); ++i) {
+                QLayoutItem *item = itemList.at(i);
+                const QSize &itemSizeHint = sizes.at(i);
+
+                int nextY = y + itemSizeHint.height() + verticalSpacing;
 
                 if(nextY - verticalSpacing > effectiveRect.bottom() && lineWidth > 0) {
                     maxHeight = qMax(y, maxHeight);
                     y = effectiveRect.y();
                     x = x + lineWidth + horizontalSpacing;
-                    nextY = y + item->sizeHint().height() + verticalSpacing;
+                    nextY = y + itemSizeHint.height() + verticalSpacing;
                     lineWidth = 0;
                 }
 
                 if (!testOnly)
-                    item->setGeometry(QRect(QPoint(x, y), item->sizeHint()));
+                    item->setGeometry(QRect(QPoint(x, y), itemSizeHint));
 
                 y = nextY;
-                lineWidth = qMax(lineWidth, item->sizeHint().width());
+                lineWidth = qMax(lineWidth, itemSizeHint.width());
             }
 
             size_hint = QSize(x + lineWidth - rect.x() + right, maxHeight);
@@ -215,6 +319,7 @@ DFlowLayout::~DFlowLayout()
 void DFlowLayout::insertItem(int index, QLayoutItem *item)
 {
     d_func()->itemList.insert(index, item);
+    invalidate();
 
     Q_EMIT countChanged(count());
 }
@@ -393,7 +498,19 @@ int DFlowLayout::heightForWidth(int width) const
         return d->sizeHint.height();
     }
 
-    return d->doLayout(QRect(0, 0, width, 0), true).height();
+    // 一次调整大小的过程中 QLayout 会多次查询相同宽度的高度
+    auto it = d->heightForWidthCache.constFind(width);
+    if (it != d->heightForWidthCache.constEnd())
+        return it.value();
+
+    int height = d->doLayout(QRect(0, 0, width, 0), true).height();
+
+    if (d->heightForWidthCache.size() >= 64)
+        d->heightForWidthCache.clear();
+
+    d->heightForWidthCache.insert(width, height);
+
+    return height;
 }
 
 /*!
@@ -439,6 +556,18 @@ void DFlowLayout::setGeometry(const QRect &rect)
                                d_func()->doLayout(rect, false)));
 }
 
+/*
+ * \reimp
+ */
+void DFlowLayout::invalidate()
+{
+    D_D(DFlowLayout);
+
+    d->clearCache();
+
+    QLayout::invalidate();
+}
+
 /*
  * \reimp
  */
@@ -460,6 +589,7 @@ QLayoutItem *DFlowLayout::takeAt(int index)
     }
 
     QLayoutItem *item = d->itemList.takeAt(index);
+    invalidate();
 
     if (QLayout *l = item->layout()) {
         // sanity check in case the user passed something weird to QObject::setParent()
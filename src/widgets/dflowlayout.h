@@ -64,6 +64,7 @@ public:
     QLayoutItem *itemAt(int index) const Q_DECL_OVERRIDE;
     QSize minimumSize() const Q_DECL_OVERRIDE;
     void setGeometry(const QRect &rect) Q_DECL_OVERRIDE;
+    void invalidate() Q_DECL_OVERRIDE;
     QSize sizeHint() const Q_DECL_OVERRIDE;
     QLayoutItem *takeAt(int index) Q_DECL_OVERRIDE;
     Qt::Orientations expandingDirections() const Q_DECL_OVERRIDE;
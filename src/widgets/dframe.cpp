@@ -27,6 +27,9 @@
 #include <QPainter>
 #include <QStyle>
 #include <QStyleOptionFrame>
+#include <QPixmapCache>
+#include <QPaintEvent>
+#include <qdrawutil.h>
 
 DWIDGET_BEGIN_NAMESPACE
 
@@ -38,6 +41,84 @@ DFramePrivate::DFramePrivate(DFrame *qq)
 
 }
 
+/*!
+ * \~chinese \brief DFramePrivate::drawCachedFrame 使用缓存的九宫格图片绘制边框
+ * \~chinese 边框只在一个最小的区域内由样式绘制一次，再拉伸到整个控件。
+ * \~chinese 需要刷新的区域在圆角和边框以内时，只使用背景色填充。
+ * \~chinese \return 无法使用缓存绘制时返回 false
+ */
+bool DFramePrivate::drawCachedFrame(QPainter *pa, const QStyleOptionFrame &opt, const QRegion &dirtyRegion)
+{
+    D_Q(DFrame);
+
+    QStyle *style = q->style();
+    const qreal ratio = q->devicePixelRatioF();
+
+    // 非整数缩放时图片的边界无法和像素对齐
+    if (!qFuzzyCompare(ratio, qRound(ratio)))
+        return false;
+
+    DStyleHelper dstyle(style);
+    const int radius = frameRounded ? qMax(0, dstyle.pixelMetric(DStyle::PM_FrameRadius, &opt, q)) : 0;
+    const int frameWidth = qMax(opt.lineWidth + opt.midLineWidth, style->pixelMetric(QStyle::PM_DefaultFrameWidth, &opt, q));
+    const int margin = radius + frameWidth + 1;
+    const int side = margin * 2 + 1;
+
+    // 渐变、纹理等画刷无法拉伸，不使用缓存
+    if (pa->background().style() != Qt::SolidPattern && pa->background().style() != Qt::NoBrush)
+        return false;
+
+    if (opt.rect.width() < side || opt.rect.height() < side)
+        return false;
+
+    const QString &key = QString("dtk-frame-%1-%2-%3-%4-%5-%6-%7-%8-%9")
+            .arg(quintptr(style)).arg(int(opt.frameShape)).arg(int(opt.features)).arg(int(opt.state))
+            .arg(opt.lineWidth).arg(opt.midLineWidth).arg(margin).arg(ratio)
+            .arg(QString("%1-%2-%3").arg(pa->background().color().rgba(), 8, 16)
+                 .arg(pa->pen().color().rgba(), 8, 16).arg(pa->pen().width()));
+    QPixmap pixmap;
+
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = QPixmap(QSize(side, side) * qRound(ratio));
+        pixmap.setDevicePixelRatio(ratio);
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        QStyleOptionFrame option = opt;
+
+        option.rect = QRect(0, 0, side, side);
+        painter.setBackground(pa->background());
+        painter.setPen(pa->pen());
+        style->drawControl(QStyle::CE_ShapedFrame, &option, &painter, q);
+        painter.end();
+
+        QPixmapCache::insert(key, pixmap);
+    }
+
+    if (frameCacheKey != key) {
+        const QImage &image = pixmap.toImage();
+
+        frameCacheKey = key;
+        frameCenterColor = image.pixelColor(image.width() / 2, image.height() / 2);
+    }
+
+    const QRect &contentRect = opt.rect.marginsRemoved(QMargins(margin, margin, margin, margin));
+
+    // 只有内容区域需要刷新时（如子控件更新），无需绘制边框
+    if (contentRect.contains(dirtyRegion.boundingRect())) {
+        if (frameCenterColor.alpha() > 0) {
+            for (const QRect &rect : dirtyRegion)
+                pa->fillRect(rect, frameCenterColor);
+        }
+
+        return true;
+    }
+
+    qDrawBorderPixmap(pa, opt.rect, QMargins(margin, margin, margin, margin), pixmap);
+
+    return true;
+}
+
 /*!
  * \~chinese \brief DFrame::DFrame 用于其他需要边框的widget的基类
  * \~chinese \param parent
@@ -63,6 +144,35 @@ void DFrame::setFrameRounded(bool on)
     update();
 }
 
+/*!
+ * \~chinese \brief DFrame::setFrameCacheEnabled 设置是否缓存边框的绘制结果
+ * \~chinese 开启后边框只会被样式绘制一次，并以九宫格的方式拉伸到控件的大小，相同样式的边框
+ * \~chinese 共用同一份缓存。只有子控件等内容区域需要刷新时，不再重新绘制边框。
+ * \~chinese \note 只适用于边框可以被拉伸的情况，背景为渐变等画刷时会自动使用普通的方式绘制
+ * \~chinese \param enabled true开启　false关闭
+ */
+void DFrame::setFrameCacheEnabled(bool enabled)
+{
+    D_D(DFrame);
+
+    if (d->frameCacheEnabled == enabled)
+        return;
+
+    d->frameCacheEnabled = enabled;
+    update();
+}
+
+/*!
+ * \~chinese \brief DFrame::frameCacheEnabled 是否缓存边框的绘制结果
+ * \~chinese \sa setFrameCacheEnabled
+ */
+bool DFrame::frameCacheEnabled() const
+{
+    D_DC(DFrame);
+
+    return d->frameCacheEnabled;
+}
+
 /*!
  * \~chinese \brief DFrame::setBackgroundRole　设置边框背景画刷的角色类型
  * \~chinese \param type 背景画刷的角色类型
@@ -88,11 +198,10 @@ DFrame::DFrame(DFramePrivate &dd, QWidget *parent)
 
 void DFrame::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event)
     QStyleOptionFrame opt;
     initStyleOption(&opt);
     QPainter p(this);
-    D_DC(DFrame);
+    D_D(DFrame);
 
     if (d->frameRounded) {
         opt.features |= QStyleOptionFrame::Rounded;
@@ -105,6 +214,10 @@ void DFrame::paintEvent(QPaintEvent *event)
     }
 
     p.setPen(QPen(dp.frameBorder(), opt.lineWidth));
+
+    if (d->frameCacheEnabled && d->drawCachedFrame(&p, opt, event->region()))
+        return;
+
     style()->drawControl(QStyle::CE_ShapedFrame, &opt, &p, this);
 }
 
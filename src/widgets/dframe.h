@@ -39,6 +39,8 @@ public:
     explicit DFrame(QWidget *parent = nullptr);
 
     void setFrameRounded(bool on);
+    void setFrameCacheEnabled(bool enabled);
+    bool frameCacheEnabled() const;
     void setBackgroundRole(DGUI_NAMESPACE::DPalette::ColorType type);
     using QFrame::setBackgroundRole;
 
@@ -17,12 +17,29 @@
 
 #include "dgraphicsgloweffect.h"
 
+#include <QHash>
+
 QT_BEGIN_NAMESPACE
 extern Q_WIDGETS_EXPORT void qt_blurImage(QPainter *p, QImage &blurImage, qreal radius, bool quality, bool alphaOnly, int transposed = 0);
 QT_END_NAMESPACE
 
 DWIDGET_BEGIN_NAMESPACE
 
+// 最近一次计算出的发散效果，来源和参数都未改变时重复使用
+// 类没有 d 指针，缓存放在以对象为键的表中，对象销毁时移除
+struct GlowCache
+{
+    QImage image;
+    qint64 sourceKey = 0;
+    QSize sourceSize;
+    qreal distance = 0;
+    qreal blurRadius = 0;
+    QColor color;
+};
+
+typedef QHash<const DGraphicsGlowEffect *, GlowCache> GlowCacheHash;
+Q_GLOBAL_STATIC(GlowCacheHash, _d_glowCache)
+
 /*!
  * \~english \class DGraphicsGlowEffect
  * \brief Draw a glow effect of widget, It's the default border effect of deepin windows.
@@ -50,6 +67,10 @@ DGraphicsGlowEffect::DGraphicsGlowEffect(QObject *parent) :
     m_blurRadius(10.0),
     m_color(0, 0, 0, 80)
 {
+    connect(this, &QObject::destroyed, this, [this] {
+        if (_d_glowCache.exists())
+            _d_glowCache->remove(this);
+    });
 }
 
 /*!
@@ -84,35 +105,54 @@ void DGraphicsGlowEffect::draw(QPainter *painter)
     QTransform restoreTransform = painter->worldTransform();
     painter->setWorldTransform(QTransform());
 
-    // Calculate size for the background image
-    QSize scaleSize(sourcePx.size().width() + 2 * distance(),
-                    sourcePx.size().height() + 2 * distance());
-
-    QImage tmpImg(scaleSize, QImage::Format_ARGB32_Premultiplied);
-    QPixmap scaled = sourcePx.scaled(scaleSize);
-    tmpImg.fill(0);
-    QPainter tmpPainter(&tmpImg);
-    tmpPainter.setCompositionMode(QPainter::CompositionMode_Source);
-    tmpPainter.drawPixmap(QPointF(-distance(), -distance()), scaled);
-    tmpPainter.end();
-
-    // blur the alpha channel
-    QImage blurred(tmpImg.size(), QImage::Format_ARGB32_Premultiplied);
-    blurred.fill(0);
-    QPainter blurPainter(&blurred);
-    qt_blurImage(&blurPainter, tmpImg, blurRadius(), false, true);
-    blurPainter.end();
-
-    tmpImg = blurred;
-
-    // blacken the image...
-    tmpPainter.begin(&tmpImg);
-    tmpPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
-    tmpPainter.fillRect(tmpImg.rect(), color());
-    tmpPainter.end();
+    // 只有位置变化或者父控件重绘时不需要重新计算模糊效果
+    // 来源内容改变时会生成新的 QPixmap，比较 cacheKey 即可
+    GlowCache &cache = (*_d_glowCache)[this];
+    const bool glowCached = !cache.image.isNull()
+            && cache.sourceKey == sourcePx.cacheKey()
+            && cache.sourceSize == sourcePx.size()
+            && qFuzzyCompare(cache.distance, distance())
+            && qFuzzyCompare(cache.blurRadius, blurRadius())
+            && cache.color == color();
+
+    if (!glowCached) {
+        // Calculate size for the background image
+        QSize scaleSize(sourcePx.size().width() + 2 * distance(),
+                        sourcePx.size().height() + 2 * distance());
+
+        QImage tmpImg(scaleSize, QImage::Format_ARGB32_Premultiplied);
+        QPixmap scaled = sourcePx.scaled(scaleSize);
+        tmpImg.fill(0);
+        QPainter tmpPainter(&tmpImg);
+        tmpPainter.setCompositionMode(QPainter::CompositionMode_Source);
+        tmpPainter.drawPixmap(QPointF(-distance(), -distance()), scaled);
+        tmpPainter.end();
+
+        // blur the alpha channel
+        QImage blurred(tmpImg.size(), QImage::Format_ARGB32_Premultiplied);
+        blurred.fill(0);
+        QPainter blurPainter(&blurred);
+        qt_blurImage(&blurPainter, tmpImg, blurRadius(), false, true);
+        blurPainter.end();
+
+        tmpImg = blurred;
+
+        // blacken the image...
+        tmpPainter.begin(&tmpImg);
+        tmpPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        tmpPainter.fillRect(tmpImg.rect(), color());
+        tmpPainter.end();
+
+        cache.image = tmpImg;
+        cache.sourceKey = sourcePx.cacheKey();
+        cache.sourceSize = sourcePx.size();
+        cache.distance = distance();
+        cache.blurRadius = blurRadius();
+        cache.color = color();
+    }
 
     // draw the blurred shadow...
-    painter->drawImage(offset, tmpImg);
+    painter->drawImage(offset, cache.image);
 
     // draw the actual pixmap...
     painter->drawPixmap(offset, sourcePx, QRectF());
@@ -24,6 +24,32 @@
 
 DWIDGET_BEGIN_NAMESPACE
 
+// 控件隐藏时暂停动画，不再占用 Qt 的动画定时器，显示时恢复
+class LoadingVisibilityFilter : public QObject
+{
+public:
+    LoadingVisibilityFilter(QVariantAnimation *animation, QObject *parent)
+        : QObject(parent)
+        , animation(animation)
+    {
+    }
+
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (watched == parent()) {
+            if (event->type() == QEvent::Hide && animation->state() == QVariantAnimation::Running)
+                animation->pause();
+            else if (event->type() == QEvent::Show && animation->state() == QVariantAnimation::Paused)
+                animation->resume();
+        }
+
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    QVariantAnimation *animation;
+};
+
 DLoadingIndicatorPrivate::DLoadingIndicatorPrivate(DLoadingIndicator *qq) :
     DObjectPrivate(qq)
 {
@@ -50,6 +76,7 @@ void DLoadingIndicatorPrivate::init()
     rotateAni.setEndValue(QVariant(qreal(360.0)));
 
     q->connect(&rotateAni, SIGNAL(valueChanged(QVariant)), q, SLOT(setRotate(QVariant)));
+    q->installEventFilter(new LoadingVisibilityFilter(&rotateAni, q));
 }
 
 void DLoadingIndicatorPrivate::setLoadingItem(QGraphicsItem *item)
@@ -313,7 +340,8 @@ bool DLoadingIndicator::loading() const
 {
     D_DC(DLoadingIndicator);
 
-    return d->rotateAni.state() == QVariantAnimation::Running;
+    // 控件隐藏时动画会暂停，仍然视为正在加载
+    return d->rotateAni.state() != QVariantAnimation::Stopped;
 }
 
 /*!
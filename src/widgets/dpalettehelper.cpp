@@ -31,6 +31,72 @@ DPaletteHelperPrivate::DPaletteHelperPrivate(DPaletteHelper *qq)
 {
 }
 
+/*!
+ * \~chinese \brief DPaletteHelperPrivate::cachedPalette 返回控件继承得到的调色板
+ * \~chinese 缓存中记录了计算时控件的父控件、QPalette 的 cacheKey 以及全局的版本号，
+ * \~chinese 三者均未发生变化时直接使用缓存，不再遍历父控件。
+ */
+const DPalette &DPaletteHelperPrivate::cachedPalette(const QWidget *widget)
+{
+    D_Q(DPaletteHelper);
+
+    QWidget *parent = widget->parentWidget();
+    const QPalette &wp = widget->palette();
+    auto it = paletteCache.find(widget);
+
+    if (it != paletteCache.end()) {
+        if (it->fixed) {
+            // 控件自身的 QPalette 改变时只需要重新合并，DPalette 特有的颜色保持不变
+            if (it->paletteKey != wp.cacheKey()) {
+                it->palette.QPalette::operator=(wp);
+                it->paletteKey = wp.cacheKey();
+            }
+
+            return it->palette;
+        }
+
+        // 调色板变化时 cacheKey 会改变，父控件的调色板改变也会传递到子控件
+        if (it->generation == generation && it->parent == parent && it->paletteKey == wp.cacheKey())
+            return it->palette;
+    } else {
+        // 控件销毁时清理缓存，只在第一次缓存时连接，不需要为每个控件安装事件过滤器
+        QObject::connect(widget, &QObject::destroyed, q, [this](QObject *obj) {
+            paletteCache.remove(static_cast<const QWidget *>(obj));
+        });
+    }
+
+    DPalette palette = parent ? cachedPalette(parent)
+                              : DGuiApplicationHelper::instance()->applicationPalette();
+
+    // 判断widget对象有没有被设置过palette
+    if (widget->testAttribute(Qt::WA_SetPalette)) {
+        // 存在自定义palette时应该根据其自定义的palette获取对应色调的DPalette
+        // 判断控件自己的palette色调是否和要继承调色板色调一致
+        if (DGuiApplicationHelper::instance()->toColorType(palette) != DGuiApplicationHelper::instance()->toColorType(wp)) {
+            // 不一致时则fallback到标准的palette
+            palette = DGuiApplicationHelper::instance()->standardPalette(DGuiApplicationHelper::instance()->toColorType(wp));
+        }
+    }
+
+    // 缓存中保存合并了控件自身 QPalette 后的结果，命中时无需再次合并
+    palette.QPalette::operator=(wp);
+
+    // 递归过程中可能插入了新的数据，需要重新查找
+    CacheEntry &entry = paletteCache[widget];
+    entry.palette = palette;
+    entry.parent = parent;
+    entry.paletteKey = wp.cacheKey();
+    entry.generation = generation;
+    entry.fixed = false;
+
+    return entry.palette;
+}
+
+void DPaletteHelperPrivate::invalidate()
+{
+    ++generation;
+}
+
 DPaletteHelper::DPaletteHelper(QObject *parent)
     : QObject(parent)
     , DTK_CORE_NAMESPACE::DObject(*new DPaletteHelperPrivate(this))
@@ -38,6 +104,13 @@ DPaletteHelper::DPaletteHelper(QObject *parent)
     connect(qGuiApp, &QGuiApplication::fontChanged, this, [](const QFont &font) {
         DFontSizeManager::instance()->setFontGenericPixelSize(static_cast<quint16>(DFontSizeManager::fontPixelSize(font)));
     });
+
+    // 应用程序的调色板变化后，所有的缓存都需要失效
+    auto invalidate = [this] {
+        d_func()->invalidate();
+    };
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, invalidate);
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::paletteTypeChanged, this, invalidate);
 }
 
 DPaletteHelper::~DPaletteHelper()
@@ -65,46 +138,20 @@ DPaletteHelper *DPaletteHelper::instance()
  */
 DPalette DPaletteHelper::palette(const QWidget *widget, const QPalette &base) const
 {
-    D_DC(DPaletteHelper);
-
-    DPalette palette;
-
     if (!widget) {
         return DGuiApplicationHelper::instance()->applicationPalette();
     }
 
-    do {
-        // 先从缓存中取数据
-        if (d->paletteCache.contains(widget)) {
-            palette = d->paletteCache.value(widget);
-            break;
-        }
-
-        if (QWidget *parent = widget->parentWidget()) {
-            palette = this->palette(parent, base);
-        } else {
-            palette = DGuiApplicationHelper::instance()->applicationPalette();
-        }
-
-        // 判断widget对象有没有被设置过palette
-        if (widget->testAttribute(Qt::WA_SetPalette)) {
-            // 存在自定义palette时应该根据其自定义的palette获取对应色调的DPalette
-            const QPalette &wp = widget->palette();
-
-            // 判断控件自己的palette色调是否和要继承调色板色调一致
-            if (DGuiApplicationHelper::instance()->toColorType(palette) != DGuiApplicationHelper::instance()->toColorType(wp)) {
-                // 不一致时则fallback到标准的palette
-                palette = DGuiApplicationHelper::instance()->standardPalette(DGuiApplicationHelper::instance()->toColorType(wp));
-            }
-        }
+    DPaletteHelperPrivate *d = const_cast<DPaletteHelperPrivate *>(d_func());
+    const DPalette &cached = d->cachedPalette(widget);
 
-        // 缓存数据
-        const_cast<DPaletteHelperPrivate *>(d)->paletteCache.insert(widget, palette);
-        // 关注控件palette改变的事件
-        const_cast<QWidget *>(widget)->installEventFilter(const_cast<DPaletteHelper *>(this));
-    } while (false);
+    if (!base.resolve()) {
+        // DPalette 是隐式共享的，直接返回缓存不会产生新的内存分配
+        return cached;
+    }
 
-    palette.QPalette::operator=(base.resolve() ? base : widget->palette());
+    DPalette palette = cached;
+    palette.QPalette::operator=(base);
 
     return palette;
 }
@@ -118,8 +165,19 @@ void DPaletteHelper::setPalette(QWidget *widget, const DPalette &palette)
 {
     D_D(DPaletteHelper);
 
-    d->paletteCache.insert(widget, palette);
-    widget->installEventFilter(const_cast<DPaletteHelper *>(this));
+    if (!d->paletteCache.contains(widget)) {
+        connect(widget, &QObject::destroyed, this, [d](QObject *obj) {
+            d->paletteCache.remove(static_cast<const QWidget *>(obj));
+        });
+    }
+
+    DPaletteHelperPrivate::CacheEntry &entry = d->paletteCache[widget];
+    entry.palette = palette;
+    entry.paletteKey = 0;
+    entry.fixed = true;
+    // 子控件的缓存依赖于此控件的调色板
+    d->invalidate();
+
     // 记录此控件被设置过palette
     widget->setProperty("_d_set_palette", true);
     widget->setPalette(palette);
@@ -133,33 +191,17 @@ void DPaletteHelper::resetPalette(QWidget *widget)
 {
     D_D(DPaletteHelper);
 
-    // 清理数据
-    d->paletteCache.remove(widget);
-    widget->setProperty("_d_set_palette", QVariant());
-    widget->setAttribute(Qt::WA_SetPalette, false);
-}
-
-bool DPaletteHelper::eventFilter(QObject *watched, QEvent *event)
-{
-    D_D(DPaletteHelper);
+    // 清理数据，保留条目以免重复连接 destroyed 信号
+    auto it = d->paletteCache.find(widget);
 
-    if (Q_UNLIKELY(event->type() == QEvent::PaletteChange)) {
-        if (QWidget *widget = qobject_cast<QWidget *>(watched)) {
-            if (!widget->property("_d_set_palette").toBool()) {
-                // 清理缓存
-                d->paletteCache.remove(widget);
-            }
-        }
-    } else if (Q_UNLIKELY(event->type() == QEvent::Destroy)) {
-        if (QWidget *widget = qobject_cast<QWidget *>(watched)) {
-            if (d->paletteCache.contains(widget)) {
-                // 清理缓存
-                d->paletteCache.remove(widget);
-            }
-        }
+    if (it != d->paletteCache.end()) {
+        it->fixed = false;
+        it->generation = 0;
     }
 
-    return QObject::eventFilter(watched, event);
+    d->invalidate();
+    widget->setProperty("_d_set_palette", QVariant());
+    widget->setAttribute(Qt::WA_SetPalette, false);
 }
 
 DWIDGET_END_NAMESPACE
@@ -42,8 +42,6 @@ private:
     DPaletteHelper(QObject *parent = nullptr);
     ~DPaletteHelper() override;
 
-    bool eventFilter(QObject *watched, QEvent *event) override;
-
     D_DECLARE_PRIVATE(DPaletteHelper)
 };
 
@@ -17,10 +17,13 @@
 
 #include "dpicturesequenceview.h"
 #include "private/dpicturesequenceview_p.h"
+#include "private/danimationclock_p.h"
 
-#include <QGraphicsPixmapItem>
 #include <QImageReader>
+#include <QPainter>
+#include <QPaintEvent>
 #include <QIcon>
+#include <QtConcurrent>
 
 DWIDGET_BEGIN_NAMESPACE
 
@@ -32,35 +35,63 @@ DPictureSequenceViewPrivate::DPictureSequenceViewPrivate(DPictureSequenceView *q
 
 DPictureSequenceViewPrivate::~DPictureSequenceViewPrivate()
 {
-    for (auto *item : pictureItemList)
-    {
-        scene->removeItem(item);
-        delete item;
-    }
-
-    scene->deleteLater();
+    decodePool.clear();
 }
 
 void DPictureSequenceViewPrivate::init()
 {
     D_Q(DPictureSequenceView);
 
-    scene = new QGraphicsScene(q);
-    refreshTimer = new QTimer(q);
-    refreshTimer->setInterval(33);
+    decodePool.setMaxThreadCount(1);
 
-    q->setScene(scene);
     q->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     q->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     q->setFrameShape(QFrame::NoFrame);
-
-    q->connect(refreshTimer, SIGNAL(timeout()), q, SLOT(_q_refreshPicture()));
     q->viewport()->setAccessibleName("DPictureSequenceViewport");
 }
 
 void DPictureSequenceViewPrivate::play()
 {
-    refreshTimer->start();
+    D_Q(DPictureSequenceView);
+
+    playing = true;
+    DAnimationClock::instance()->subscribe(q, interval, [this](qint64) {
+        _q_refreshPicture();
+    });
+}
+
+void DPictureSequenceViewPrivate::stopClock()
+{
+    D_Q(DPictureSequenceView);
+
+    playing = false;
+    DAnimationClock::instance()->unsubscribe(q);
+}
+
+QRect DPictureSequenceViewPrivate::frameRect() const
+{
+    D_QC(DPictureSequenceView);
+
+    // 与 QGraphicsView 的默认对齐方式一致，所有帧以左上角对齐后整体居中显示
+    const QRect &viewRect = q->viewport()->rect();
+    QRect rect(QPoint(0, 0), sequenceSize);
+    rect.moveTopLeft(QPoint((viewRect.width() - sequenceSize.width()) / 2,
+                            (viewRect.height() - sequenceSize.height()) / 2));
+
+    return rect;
+}
+
+void DPictureSequenceViewPrivate::setCurrentFrame(const QPixmap &pixmap)
+{
+    D_Q(DPictureSequenceView);
+
+    const QRect &oldRect = frameRect();
+
+    currentFrame = pixmap;
+    sequenceSize = sequenceSize.expandedTo((QSizeF(pixmap.size()) / pixmap.devicePixelRatioF()).toSize());
+
+    // 只重绘帧所在的区域
+    q->viewport()->update(oldRect | frameRect());
 }
 
 QPixmap DPictureSequenceViewPrivate::loadPixmap(const QString &path)
@@ -88,28 +119,203 @@ QPixmap DPictureSequenceViewPrivate::loadPixmap(const QString &path)
     return pixmap;
 }
 
+QImage DPictureSequenceViewPrivate::loadImage(const QString &path, qreal devicePixelRatio)
+{
+    qreal ratio = 1.0;
+    QImageReader reader;
+
+    reader.setFileName(qt_findAtNxFile(path, devicePixelRatio, &ratio));
+    if (!reader.canRead())
+        return QImage();
+
+    if (!qFuzzyCompare(ratio, devicePixelRatio))
+        reader.setScaledSize(reader.size() * (devicePixelRatio / ratio));
+
+    QImage image = reader.read();
+    image.setDevicePixelRatio(devicePixelRatio);
+
+    return image;
+}
+
+void DPictureSequenceViewPrivate::clearSequence()
+{
+    stopClock();
+    frames.clear();
+    sequenceSize = QSize();
+    setCurrentFrame(QPixmap());
+    lastItemPos = 0;
+
+    decodePool.clear();
+    pendingFrames.clear();
+    streamingSources.clear();
+    animatedFileName.clear();
+    animationReader.reset();
+    animationFrameCount = 0;
+    nextRequestFrame = 0;
+}
+
+bool DPictureSequenceViewPrivate::isStreaming() const
+{
+    return !streamingSources.isEmpty() || !animatedFileName.isEmpty();
+}
+
+int DPictureSequenceViewPrivate::frameCount() const
+{
+    return animatedFileName.isEmpty() ? streamingSources.count() : animationFrameCount;
+}
+
+static QImage readAnimationFrame(const QSharedPointer<QImageReader> &reader, int index, const QSize &scaledSize)
+{
+    // 动图只能顺序读取，回到第一帧时重新打开文件
+    if (index == 0)
+        reader->setFileName(reader->fileName());
+
+    QImage image = reader->read();
+
+    if (!image.isNull() && scaledSize.isValid())
+        image = image.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    return image;
+}
+
+static QImage readSequenceFrame(const QString &path, qreal devicePixelRatio, const QSize &scaledSize)
+{
+    QImage image = DPictureSequenceViewPrivate::loadImage(path, devicePixelRatio);
+
+    if (!image.isNull() && scaledSize.isValid())
+        image = image.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    return image;
+}
+
+void DPictureSequenceViewPrivate::startStreaming()
+{
+    D_Q(DPictureSequenceView);
+
+    // 丢弃尚未开始的解码任务，已经开始的任务结果会被忽略
+    decodePool.clear();
+    pendingFrames.clear();
+    lastItemPos = 0;
+    nextRequestFrame = 0;
+
+    if (!animatedFileName.isEmpty()) {
+        // 旧的 reader 可能还在被解码任务使用，重新创建一个
+        animationReader.reset(new QImageReader(animatedFileName));
+    }
+
+    const int count = frameCount();
+
+    if (count <= 0)
+        return;
+
+    const QSize &scaledSize = streamingAutoScale ? q->size() : QSize();
+
+    // 同步解码第一帧，保证首次绘制时就有内容
+    if (animationReader) {
+        showStreamingFrame(readAnimationFrame(animationReader, 0, scaledSize));
+    } else {
+        showStreamingFrame(readSequenceFrame(streamingSources.first(), q->devicePixelRatioF(), scaledSize));
+    }
+
+    nextRequestFrame = 1 % count;
+    requestFrames();
+}
+
+void DPictureSequenceViewPrivate::requestFrames()
+{
+    D_Q(DPictureSequenceView);
+
+    const int count = frameCount();
+    const int limit = qMin(streamingBufferSize, count);
+    const QSize &scaledSize = streamingAutoScale ? q->size() : QSize();
+    const qreal devicePixelRatio = q->devicePixelRatioF();
+
+    // 按播放顺序请求后续的帧，动图的解码任务依赖这个顺序
+    while (pendingFrames.count() < limit && !pendingFrames.contains(nextRequestFrame)) {
+        const int index = nextRequestFrame;
+
+        if (animationReader) {
+            QSharedPointer<QImageReader> reader = animationReader;
+            pendingFrames.insert(index, QtConcurrent::run(&decodePool, [reader, index, scaledSize] {
+                return readAnimationFrame(reader, index, scaledSize);
+            }));
+        } else {
+            const QString &path = streamingSources.at(index);
+            pendingFrames.insert(index, QtConcurrent::run(&decodePool, [path, devicePixelRatio, scaledSize] {
+                return readSequenceFrame(path, devicePixelRatio, scaledSize);
+            }));
+        }
+
+        nextRequestFrame = (index + 1) % count;
+    }
+}
+
+void DPictureSequenceViewPrivate::showStreamingFrame(const QImage &image)
+{
+    setCurrentFrame(QPixmap::fromImage(image));
+}
+
+void DPictureSequenceViewPrivate::refreshStreamingPicture()
+{
+    const int count = frameCount();
+
+    if (count <= 0)
+        return;
+
+    int next = lastItemPos + 1;
+    const bool wrapped = next >= count;
+
+    if (wrapped)
+        next = 0;
+
+    auto frame = pendingFrames.find(next);
+
+    if (frame == pendingFrames.end()) {
+        requestFrames();
+        return;
+    }
+
+    // 解码还未完成时停留在当前帧
+    if (!frame->isFinished())
+        return;
+
+    showStreamingFrame(frame->result());
+    pendingFrames.erase(frame);
+    lastItemPos = next;
+    requestFrames();
+
+    if (wrapped) {
+        if (singleShot)
+            stopClock();
+
+        D_QC(DPictureSequenceView);
+
+        Q_EMIT q->playEnd();
+    }
+}
+
 void DPictureSequenceViewPrivate::_q_refreshPicture()
 {
-    QGraphicsPixmapItem *item = pictureItemList.value(lastItemPos++);
+    if (isStreaming()) {
+        refreshStreamingPicture();
+        return;
+    }
 
-    if (item)
-        item->hide();
+    if (frames.isEmpty())
+        return;
 
-    if (lastItemPos == pictureItemList.count()) {
+    if (++lastItemPos == frames.count()) {
         lastItemPos = 0;
 
         if (singleShot)
-            refreshTimer->stop();
+            stopClock();
 
         D_QC(DPictureSequenceView);
 
         Q_EMIT q->playEnd();
     }
 
-    item = pictureItemList.value(lastItemPos);
-
-    if (item)
-        item->show();
+    setCurrentFrame(frames.at(lastItemPos));
 }
 
 /*!
@@ -189,6 +395,16 @@ void DPictureSequenceView::setPictureSequence(const QStringList &sequence, const
 {
     D_D(DPictureSequenceView);
 
+    if (d->streaming) {
+        d->clearSequence();
+        d->streamingSources = sequence;
+        d->streamingAutoScale = autoScale;
+        d->startStreaming();
+
+        setStyleSheet("background-color:transparent;");
+        return;
+    }
+
     QList<QPixmap> pixmapSequence;
     for (const QString &path : sequence) {
         pixmapSequence << d->loadPixmap(path);
@@ -211,26 +427,54 @@ void DPictureSequenceView::setPictureSequence(const QList<QPixmap> &sequence, co
 {
     D_D(DPictureSequenceView);
 
-    stop();
-    d->scene->clear();
-    d->pictureItemList.clear();
+    d->clearSequence();
 
     for (QPixmap pixmap : sequence) {
         if (autoScale) {
             pixmap = pixmap.scaled(size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
         }
 
-        d->pictureItemList << d->scene->addPixmap(pixmap);
-        d->pictureItemList.last()->hide();
+        d->frames << pixmap;
+        d->sequenceSize = d->sequenceSize.expandedTo((QSizeF(pixmap.size()) / pixmap.devicePixelRatioF()).toSize());
     }
 
-    if (!d->pictureItemList.isEmpty()) {
-        d->pictureItemList.first()->show();
+    if (!d->frames.isEmpty()) {
+        d->setCurrentFrame(d->frames.first());
     }
 
     setStyleSheet("background-color:transparent;");
 }
 
+/*!
+ * \~english \brief Set picture source with an animated image file, such as GIF, animated WebP or APNG.
+ * Frames are always streamed: only a few upcoming frames are decoded on a worker thread.
+ * \param fileName animated image file.
+ * \param autoScale auto resize source image to widget size, default to false.
+ * \sa streamingBufferSize
+ */
+/*!
+ * \~chinese \brief 通过动图文件（如 GIF、WebP 动图、APNG）来设置图片序列。
+ * 动图总是以流式方式播放，只在后台线程中解码即将播放的少量帧。
+ * \param fileName 动图文件路径。
+ * \param autoScale 是否自动缩放图片，默认不缩放。
+ * \sa streamingBufferSize
+ */
+void DPictureSequenceView::setAnimatedPicture(const QString &fileName, const bool autoScale)
+{
+    D_D(DPictureSequenceView);
+
+    d->clearSequence();
+
+    QImageReader reader(fileName);
+
+    d->animatedFileName = fileName;
+    d->animationFrameCount = reader.canRead() ? qMax(1, reader.imageCount()) : 0;
+    d->streamingAutoScale = autoScale;
+    d->startStreaming();
+
+    setStyleSheet("background-color:transparent;");
+}
+
 /*!
  * \~english \brief Start/resume update timer and show animation.
  */
@@ -254,7 +498,7 @@ void DPictureSequenceView::pause()
 {
     D_D(DPictureSequenceView);
 
-    d->refreshTimer->stop();
+    d->stopClock();
 }
 
 /*!
@@ -267,26 +511,33 @@ void DPictureSequenceView::stop()
 {
     D_D(DPictureSequenceView);
 
-    d->refreshTimer->stop();
-    if (d->pictureItemList.count() > d->lastItemPos)
-        d->pictureItemList[d->lastItemPos]->hide();
-    if (!d->pictureItemList.isEmpty())
-        d->pictureItemList[0]->show();
+    d->stopClock();
+
+    if (d->isStreaming()) {
+        d->startStreaming();
+        return;
+    }
+
     d->lastItemPos = 0;
+    if (!d->frames.isEmpty())
+        d->setCurrentFrame(d->frames.first());
 }
 
 int DPictureSequenceView::speed() const
 {
     D_DC(DPictureSequenceView);
 
-    return d->refreshTimer->interval();
+    return d->interval;
 }
 
 void DPictureSequenceView::setSpeed(int speed)
 {
     D_D(DPictureSequenceView);
 
-    d->refreshTimer->setInterval(speed);
+    d->interval = speed;
+
+    if (d->playing)
+        d->play();
 }
 
 bool DPictureSequenceView::singleShot() const
@@ -303,6 +554,71 @@ void DPictureSequenceView::setSingleShot(bool singleShot)
     d->singleShot = singleShot;
 }
 
+/*!
+ * \~english \property DPictureSequenceView::streaming
+ * \brief Decode frames on demand instead of all at once.
+ * When enabled, the next setPictureSequence() call with file paths keeps only
+ * streamingBufferSize upcoming frames in memory, decoded on a worker thread;
+ * frames behind the playhead are dropped. Default to false.
+ */
+/*!
+ * \~chinese \property DPictureSequenceView::streaming
+ * \brief 是否以流式方式播放图片序列。
+ * 开启后，之后通过文件路径设置的图片序列不会一次性全部解码，而是在后台线程中解码
+ * 即将播放的 streamingBufferSize 帧，已播放的帧随即释放。默认关闭。
+ */
+bool DPictureSequenceView::streaming() const
+{
+    D_DC(DPictureSequenceView);
+
+    return d->streaming;
+}
+
+void DPictureSequenceView::setStreaming(bool streaming)
+{
+    D_D(DPictureSequenceView);
+
+    d->streaming = streaming;
+}
+
+/*!
+ * \~english \property DPictureSequenceView::streamingBufferSize
+ * \brief Number of upcoming frames decoded ahead in streaming mode, default to 4.
+ */
+/*!
+ * \~chinese \property DPictureSequenceView::streamingBufferSize
+ * \brief 流式播放时预先解码的帧数，默认为 4。
+ */
+int DPictureSequenceView::streamingBufferSize() const
+{
+    D_DC(DPictureSequenceView);
+
+    return d->streamingBufferSize;
+}
+
+void DPictureSequenceView::setStreamingBufferSize(int size)
+{
+    D_D(DPictureSequenceView);
+
+    d->streamingBufferSize = qMax(1, size);
+}
+
+void DPictureSequenceView::paintEvent(QPaintEvent *event)
+{
+    D_D(DPictureSequenceView);
+
+    if (d->currentFrame.isNull())
+        return;
+
+    const QRect &rect = d->frameRect();
+
+    if (!event->rect().intersects(rect))
+        return;
+
+    QPainter painter(viewport());
+    painter.drawPixmap(rect.topLeft(), d->currentFrame);
+}
+
 DWIDGET_END_NAMESPACE
 
 #include "moc_dpicturesequenceview.cpp"
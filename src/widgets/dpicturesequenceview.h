@@ -33,6 +33,8 @@ class LIBDTKWIDGETSHARED_EXPORT DPictureSequenceView : public QGraphicsView, pub
     Q_OBJECT
     Q_PROPERTY(int speed READ speed WRITE setSpeed NOTIFY speedChanged)
     Q_PROPERTY(bool singleShot READ singleShot WRITE setSingleShot)
+    Q_PROPERTY(bool streaming READ streaming WRITE setStreaming)
+    Q_PROPERTY(int streamingBufferSize READ streamingBufferSize WRITE setStreamingBufferSize)
 
 public:
     DPictureSequenceView(QWidget *parent = nullptr);
@@ -40,6 +42,7 @@ public:
     void setPictureSequence(const QString &srcFormat, const QPair<int, int> &range, const int fieldWidth = 0, const bool autoScale = false);
     void setPictureSequence(const QStringList &sequence, const bool autoScale = false);
     void setPictureSequence(const QList<QPixmap> &sequence, const bool autoScale = false);
+    void setAnimatedPicture(const QString &fileName, const bool autoScale = false);
     void play();
     void pause();
     void stop();
@@ -50,10 +53,19 @@ public:
     bool singleShot() const;
     void setSingleShot(bool singleShot);
 
+    bool streaming() const;
+    void setStreaming(bool streaming);
+
+    int streamingBufferSize() const;
+    void setStreamingBufferSize(int size);
+
 Q_SIGNALS:
     void speedChanged(int speed) const;
     void playEnd() const;
 
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
 private:
     D_PRIVATE_SLOT(void _q_refreshPicture())
 
@@ -6,10 +6,17 @@
 #include <QFileInfo>
 #include <QtConcurrent>
 #include <QtAlgorithms>
+#include <QTimer>
 
 #include <cups/cups.h>
 #include <cups/ppd.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #define FIRST_PAGE 1
 #define FIRST_INDEX 0
 
@@ -24,41 +31,233 @@
 #define WATER_TEXTSPACE WATER_DEFAULTFONTSIZE
 
 DWIDGET_BEGIN_NAMESPACE
-// 取自Qt源码qpixmapfilter.cpp 945行
-static void grayscale(const QImage &image, QImage &dest, const QRect &rect = QRect())
+// 单行像素的灰度转换，结果与 qGray 一致并保留 alpha 通道，src 与 dst 可以相同
+static void grayscaleLine(const QRgb *src, QRgb *dst, int count)
 {
-    QRect destRect = rect;
-    QRect srcRect = rect;
-    if (rect.isNull()) {
-        srcRect = dest.rect();
-        destRect = dest.rect();
+    int x = 0;
+#if defined(__SSE2__)
+    const __m128i channelMask = _mm_set1_epi32(0xff);
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000));
+    const __m128i rFactor = _mm_set1_epi32(11);
+    const __m128i bFactor = _mm_set1_epi32(5);
+
+    for (; x + 4 <= count; x += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+        const __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), channelMask);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), channelMask);
+        const __m128i b = _mm_and_si128(pixels, channelMask);
+
+        // 各分量的高 16 位都为 0，可以直接使用 16 位乘法
+        __m128i gray = _mm_add_epi32(_mm_mullo_epi16(r, rFactor), _mm_slli_epi32(g, 4));
+        gray = _mm_srli_epi32(_mm_add_epi32(gray, _mm_mullo_epi16(b, bFactor)), 5);
+        gray = _mm_or_si128(gray, _mm_or_si128(_mm_slli_epi32(gray, 8), _mm_slli_epi32(gray, 16)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_or_si128(gray, _mm_and_si128(pixels, alphaMask)));
+    }
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON)) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const uint8x8_t rFactor = vdup_n_u8(11);
+    const uint8x8_t gFactor = vdup_n_u8(16);
+    const uint8x8_t bFactor = vdup_n_u8(5);
+
+    for (; x + 8 <= count; x += 8) {
+        // 小端序下内存中的分量顺序为 B G R A
+        uint8x8x4_t pixels = vld4_u8(reinterpret_cast<const uint8_t *>(src + x));
+        uint16x8_t sum = vmull_u8(pixels.val[2], rFactor);
+        sum = vmlal_u8(sum, pixels.val[1], gFactor);
+        sum = vmlal_u8(sum, pixels.val[0], bFactor);
+
+        const uint8x8_t gray = vshrn_n_u16(sum, 5);
+        pixels.val[0] = gray;
+        pixels.val[1] = gray;
+        pixels.val[2] = gray;
+        vst4_u8(reinterpret_cast<uint8_t *>(dst + x), pixels);
+    }
+#endif
+
+    for (; x < count; ++x) {
+        int val = qGray(src[x]);
+        dst[x] = qRgba(val, val, val, qAlpha(src[x]));
     }
-    if (&image != &dest) {
-        destRect.moveTo(QPoint(0, 0));
+}
+
+/*!
+ * \~chinese \brief grayscaleImage 返回图片的灰度图，格式与原图一致（非 32 位的图片会先转换为 ARGB32）
+ * \~chinese 按行进行转换，较大的图片会被分成多个行块在线程池中并行处理
+ */
+static QImage grayscaleImage(const QImage &image)
+{
+    if (image.isNull())
+        return image;
+
+    QImage source = image;
+    switch (source.format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        break;
+    default:
+        source = source.convertToFormat(QImage::Format_ARGB32);
+        break;
     }
 
-    const unsigned int *data = reinterpret_cast<const unsigned int *>(image.bits());
-    unsigned int *outData = reinterpret_cast<unsigned int *>(dest.bits());
+    QImage dest(source.size(), source.format());
+    if (dest.isNull())
+        return dest;
+
+    dest.setDevicePixelRatio(source.devicePixelRatio());
+
+    const int width = source.width();
+    const int height = source.height();
+    const uchar *srcBits = source.constBits();
+    const int srcStride = source.bytesPerLine();
+    // 先取出目标数据的地址，避免在工作线程中触发 detach
+    uchar *destBits = dest.bits();
+    const int destStride = dest.bytesPerLine();
 
-    if (dest.size() == image.size() && image.rect() == srcRect) {
-        // a bit faster loop for grayscaling everything
-        int pixels = dest.width() * dest.height();
-        for (int i = 0; i < pixels; ++i) {
-            int val = qGray(data[i]);
-            outData[i] = qRgba(val, val, val, qAlpha(data[i]));
+    auto convertRows = [ = ](int from, int to) {
+        for (int y = from; y < to; ++y) {
+            grayscaleLine(reinterpret_cast<const QRgb *>(srcBits + y * srcStride),
+                          reinterpret_cast<QRgb *>(destBits + y * destStride), width);
         }
+    };
+
+    const int bandHeight = 64;
+    if (qint64(width) * height < 512 * 512 || QThreadPool::globalInstance()->maxThreadCount() < 2) {
+        convertRows(0, height);
     } else {
-        int yd = destRect.top();
-        for (int y = srcRect.top(); y <= srcRect.bottom() && y < image.height(); y++) {
-            data = reinterpret_cast<const unsigned int *>(image.scanLine(y));
-            outData = reinterpret_cast<unsigned int *>(dest.scanLine(yd++));
-            int xd = destRect.left();
-            for (int x = srcRect.left(); x <= srcRect.right() && x < image.width(); x++) {
-                int val = qGray(data[x]);
-                outData[xd++] = qRgba(val, val, val, qAlpha(data[x]));
-            }
+        QVector<int> bands;
+        for (int y = 0; y < height; y += bandHeight)
+            bands.append(y);
+
+        QtConcurrent::blockingMap(bands, [ = ](int y) {
+            convertRows(y, qMin(y + bandHeight, height));
+        });
+    }
+
+    return dest;
+}
+
+static void drawSinglePage(QPainter *painter, const QSize &translateSize, const QPointF &leftTop, const QImage &waterImage,
+                           const QPicture *picture, qreal scale, const QSize &pageSize, qreal waterRotation)
+{
+    // 绘制原始数据
+    painter->save();
+    if (scale > 1) {
+        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
+        QImage tmpImage(pageSize * scale, QImage::Format_ARGB32);
+        tmpImage.fill(Qt::white);
+        QPainter tmpPainter(&tmpImage);
+        tmpPainter.scale(scale, scale);
+        tmpPainter.drawPicture(0, 0, *picture);
+
+        painter->setRenderHint(QPainter::SmoothPixmapTransform);
+        // 将缩放系数设置为1
+        painter->resetTransform();
+        // 由小到大缩放的时候  图片数据容易失真  这里直接将原始数据绘制到放大后的图片中 然后再进行绘图 数据失真程度较低
+        painter->drawImage(leftTop, tmpImage);
+    } else {
+        painter->drawPicture(leftTop, *picture);
+    }
+    // 绘制水印
+    if (!waterImage.isNull()) {
+        painter->resetTransform();
+        painter->translate(translateSize.width() / 2, translateSize.height() / 2);
+        painter->rotate(waterRotation);
+
+        painter->drawImage(-waterImage.width() / 2, -waterImage.height() / 2, waterImage);
+    }
+
+    painter->restore();
+}
+
+static void drawMultiPage(QPainter *painter, const QPointF &leftTop, const QImage &waterImage, const QVector<const QPicture *> &pictures,
+                          const QVector<QPointF> &paintPoints, qreal scaleRatio, qreal scale, const QSize &pageSize)
+{
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+
+    painter->save();
+    painter->scale(scaleRatio, scaleRatio);
+    if (scale > 1) {
+        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
+        QImage tmpImage(pageSize / scaleRatio, QImage::Format_ARGB32);
+        tmpImage.fill(Qt::white);
+        QPainter tmpPainter(&tmpImage);
+
+        // 为了保证并打缩放的清晰度 防止先缩放小再缩放大导致图像不清晰的问题 这里直接将并打内容放大 然后在统一缩小到并打大小
+        for (int c = 0; c < pictures.count(); ++c) {
+            QPointF paintPoint = paintPoints.at(c) / scaleRatio;
+            tmpPainter.drawPicture(paintPoint, *pictures.at(c));
+        }
+
+        painter->drawImage(leftTop / scaleRatio, tmpImage);
+    } else {
+        for (int c = 0; c < pictures.count(); ++c) {
+            QPointF paintPoint = paintPoints.at(c) / scaleRatio;
+            painter->drawPicture(leftTop / scaleRatio + paintPoint, *pictures.at(c));
         }
     }
+    painter->restore();
+
+    // 绘制并打水印 此时不能再设置缩放比
+    if (!waterImage.isNull())
+        painter->drawImage(leftTop, waterImage);
+}
+
+// 导出图片时所有页面共用的参数
+struct ImageExportContext
+{
+    QSize paperSize;
+    QRect clipRect;
+    QSize pageSize;
+    QPointF leftTop;
+    QSize translateSize;
+    qreal scale;
+    qreal waterRotation;
+    bool numberUp;
+    QString outPutFileName;
+    QString suffix;
+    bool isJpegImage;
+};
+
+// 导出图片时单个页面的数据
+struct ImageExportPage
+{
+    int index = 0;
+    QVector<const QPicture *> pictures;
+    QVector<QPointF> paintPoints;
+    qreal scaleRatio = 1;
+    QImage waterImage;
+};
+
+static int imageExportPageBudget()
+{
+    bool ok = false;
+    int budget = qEnvironmentVariableIntValue("DTK_PRINT_IMAGE_PAGE_BUDGET", &ok);
+    if (!ok || budget <= 0)
+        budget = QThread::idealThreadCount() * 2;
+
+    return qMax(1, budget);
+}
+
+static QImage renderExportPage(const ImageExportContext &context, const ImageExportPage &page)
+{
+    QImage image(context.paperSize, QImage::Format_ARGB32);
+    image.fill(Qt::white);
+
+    const QVector<const QPicture *> &pictures = page.pictures;
+
+    QPainter painter(&image);
+    painter.setClipRect(context.clipRect);
+    painter.scale(context.scale, context.scale);
+
+    if (context.numberUp) {
+        drawMultiPage(&painter, context.leftTop, page.waterImage, pictures, page.paintPoints, page.scaleRatio, context.scale, context.pageSize);
+    } else if (!pictures.isEmpty()) {
+        drawSinglePage(&painter, context.translateSize, context.leftTop, page.waterImage, pictures.first(), context.scale, context.pageSize, context.waterRotation);
+    }
+    painter.end();
+
+    return image;
 }
 
 static void saveImageToFile(int index, const QString &outPutFileName, const QString &suffix, bool isJpegImage, const QImage &srcImage)
@@ -67,10 +266,7 @@ static void saveImageToFile(int index, const QString &outPutFileName, const QStr
     QString stres = outPutFileName.right(suffix.length() + 1);
     QString tmpString = outPutFileName.left(outPutFileName.length() - suffix.length() - 1) + QString("(%1)").arg(QString::number(index + 1)) + stres;
 
-    // 多线程保存文件修复大文件卡顿问题
-    QtConcurrent::run(QThreadPool::globalInstance(), [srcImage, tmpString, isJpegImage] {
-        srcImage.save(tmpString, isJpegImage ? "JPEG" : "PNG");
-    });
+    srcImage.save(tmpString, isJpegImage ? "JPEG" : "PNG");
 }
 
 DPrintPreviewWidgetPrivate::DPrintPreviewWidgetPrivate(DPrintPreviewWidget *qq)
@@ -115,6 +311,13 @@ void DPrintPreviewWidgetPrivate::init()
     layout->addWidget(graphicsView);
 
     colorMode = previewPrinter->colorMode();
+
+    prefetchTimer = new QTimer(q);
+    prefetchTimer->setSingleShot(true);
+    prefetchTimer->setInterval(PREVIEW_PREFETCH_DELAY);
+    q->connect(prefetchTimer, &QTimer::timeout, q, [this] {
+        prefetchPictures();
+    });
 }
 
 void DPrintPreviewWidgetPrivate::populateScene()
@@ -175,11 +378,17 @@ void DPrintPreviewWidgetPrivate::generatePreview()
             setCurrentPageNumber(FIRST_PAGE);
         }
 
+        // 文档需要重新生成，之前录制的页面都已失效
+        pictureCache.clear();
+        pictureCacheEnabled = true;
         previewPages = requestPages(currentPageNumber);
     }
     generatePreviewPicture();
     populateScene();
 
+    if (isAsynPreview)
+        schedulePrefetch();
+
     // 同步或者异步（全部，当前）页码时 更新总页码
     if (!isAsynPreview || (isAsynPreview && pageRangeMode != DPrintPreviewWidget::SelectPage))
         setPageRangeAll();
@@ -305,27 +514,70 @@ void DPrintPreviewWidgetPrivate::syncPrint(const QPointF &leftTop, const QRect &
 void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<int> &pageVector)
 {
     QMargins pageMargins = previewPrinter->pageLayout().marginsPixels(previewPrinter->resolution());
-    QImage savedImages(paperSize, QImage::Format_ARGB32);
-    QString outPutFileName = previewPrinter->outputFileName();
-    QString suffix = QFileInfo(outPutFileName).suffix();
-    bool isJpegImage = !suffix.compare(QLatin1String("jpeg"), Qt::CaseInsensitive);
     QImage waterMarkImage = (imposition == DPrintPreviewWidget::One) ? generateWaterMarkImage() : QImage();
 
-    savedImages.fill(Qt::white);
-
-    QPainter painter(&savedImages);
-    painter.setClipRect(previewPrinter->pageRect());
-    painter.scale(scale, scale);
+    ImageExportContext context;
+    context.paperSize = paperSize;
+    context.clipRect = previewPrinter->pageRect();
+    context.pageSize = previewPrinter->pageRect().size();
+    context.scale = scale;
+    context.waterRotation = waterMark->rotation();
+    context.numberUp = imposition != DPrintPreviewWidget::One;
+    context.outPutFileName = previewPrinter->outputFileName();
+    context.suffix = QFileInfo(context.outPutFileName).suffix();
+    context.isJpegImage = !context.suffix.compare(QLatin1String("jpeg"), Qt::CaseInsensitive);
 
-    QPointF leftTopPoint;
     if (scale >= 1.0) {
-        leftTopPoint = QPointF(pageMargins.left() / scale, pageMargins.top() / scale);
+        context.leftTop = QPointF(pageMargins.left() / scale, pageMargins.top() / scale);
     } else {
-        leftTopPoint = {paperSize.width() * (1.0 - scale) / (2.0 * scale) + pageMargins.left(), paperSize.height() * (1.0 - scale) / (2.0 * scale) + pageMargins.top()};
+        context.leftTop = {paperSize.width() * (1.0 - scale) / (2.0 * scale) + pageMargins.left(), paperSize.height() * (1.0 - scale) / (2.0 * scale) + pageMargins.top()};
     }
 
     // 水印需要调整的位置大小  跟随页面内容位置变化
-    QSize translateSize = paperSize + QSize(pageMargins.left() - pageMargins.right(), pageMargins.top() - pageMargins.bottom());
+    context.translateSize = paperSize + QSize(pageMargins.left() - pageMargins.right(), pageMargins.top() - pageMargins.bottom());
+
+    // 页面数据只能在主线程中回放，绘制完成后在线程池中编码保存，同时保存的页面数量受限，以控制内存占用
+    const int pageBudget = imageExportPageBudget();
+    QList<QFuture<void>> runningPages;
+
+    auto exportPage = [&](const ImageExportPage &page) {
+        for (auto it = runningPages.begin(); it != runningPages.end();) {
+            if (it->isFinished())
+                it = runningPages.erase(it);
+            else
+                ++it;
+        }
+
+        while (runningPages.count() >= pageBudget)
+            runningPages.takeFirst().waitForFinished();
+
+        const QImage image = renderExportPage(context, page);
+        const int index = page.index;
+        runningPages.append(QtConcurrent::run(QThreadPool::globalInstance(), [context, index, image] {
+            saveImageToFile(index, context.outPutFileName, context.suffix, context.isJpegImage, image);
+        }));
+    };
+
+    auto singlePage = [&](int index, const QPicture *picture) {
+        ImageExportPage page;
+        page.index = index;
+        page.pictures.append(picture);
+        page.waterImage = waterMarkImage;
+        exportPage(page);
+    };
+
+    auto numberUpPage = [&](int index) {
+        ImageExportPage page;
+        page.index = index;
+        page.paintPoints = numberUpPrintData->paintPoints;
+        page.scaleRatio = numberUpPrintData->scaleRatio;
+        page.waterImage = waterMarkImage;
+
+        for (const auto &item : qAsConst(numberUpPrintData->previewPictures))
+            page.pictures.append(item.second);
+
+        exportPage(page);
+    };
 
     if (isAsynPreview) {
         // 异步先获取需要打印的数据
@@ -341,9 +593,7 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
             // 异步+非并打
             // 异步模式下pictures可以直接按顺序拿取
             for (int i = 0; i < pageVector.size(); ++i) {
-                printSinglePageDrawUtil(&painter, translateSize, leftTopPoint, waterMarkImage, pictures.at(i));
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
+                singlePage(i, pictures.at(i));
             }
         } else {
             // 异步+并打
@@ -366,9 +616,7 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
                 if ((0 == i) || (numberUpPrintData->previewPictures.count() != numberUpPrintData->paintPoints.count()))
                     waterMarkImage = generateWaterMarkImage();
 
-                printMultiPageDrawUtil(&painter, leftTopPoint, waterMarkImage);
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
+                numberUpPage(i);
             }
         }
     } else {
@@ -378,9 +626,7 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
             // 同步+非并打
             // 同步模式下需要按照位置拿取
             for (int i = 0; i < pageVector.size(); ++i) {
-                printSinglePageDrawUtil(&painter, translateSize, leftTopPoint, waterMarkImage, pictures[pageVector.at(i) - 1]);
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
+                singlePage(i, pictures[pageVector.at(i) - 1]);
             }
         } else {
             // 同步+并打
@@ -398,9 +644,7 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
                 if ((0 == i) || (numberUpPrintData->previewPictures.count() != numberUpPrintData->paintPoints.count()))
                     waterMarkImage = generateWaterMarkImage();
 
-                printMultiPageDrawUtil(&painter, leftTopPoint, waterMarkImage);
-                saveImageToFile(i, outPutFileName, suffix, isJpegImage, savedImages);
-                savedImages.fill(Qt::white);
+                numberUpPage(i);
             }
         }
     }
@@ -408,68 +652,16 @@ void DPrintPreviewWidgetPrivate::printAsImage(const QSize &paperSize, QVector<in
 
 void DPrintPreviewWidgetPrivate::printSinglePageDrawUtil(QPainter *painter, const QSize &translateSize, const QPointF &leftTop, const QImage &waterImage, const QPicture *picture)
 {
-    // 绘制原始数据
-    painter->save();
-    if (scale > 1) {
-        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
-        QImage tmpImage(previewPrinter->pageRect().size() * scale, QImage::Format_ARGB32);
-        tmpImage.fill(Qt::white);
-        QPainter tmpPainter(&tmpImage);
-        tmpPainter.scale(scale, scale);
-        tmpPainter.drawPicture(0, 0, *picture);
-
-        painter->setRenderHint(QPainter::SmoothPixmapTransform);
-        // 将缩放系数设置为1
-        painter->resetTransform();
-        // 由小到大缩放的时候  图片数据容易失真  这里直接将原始数据绘制到放大后的图片中 然后再进行绘图 数据失真程度较低
-        painter->drawImage(leftTop, tmpImage);
-    } else {
-        painter->drawPicture(leftTop, *picture);
-    }
-    // 绘制水印
-    if (!waterImage.isNull()) {
-        painter->resetTransform();
-        painter->translate(translateSize.width() / 2, translateSize.height() / 2);
-        painter->rotate(waterMark->rotation());
-
-        painter->drawImage(-waterImage.width() / 2, -waterImage.height() / 2, waterImage);
-    }
-
-    painter->restore();
+    drawSinglePage(painter, translateSize, leftTop, waterImage, picture, scale, previewPrinter->pageRect().size(), waterMark->rotation());
 }
 
 void DPrintPreviewWidgetPrivate::printMultiPageDrawUtil(QPainter *painter, const QPointF &leftTop, const QImage &waterImage)
 {
-    painter->setRenderHint(QPainter::SmoothPixmapTransform);
-
-    painter->save();
-    painter->scale(numberUpPrintData->scaleRatio, numberUpPrintData->scaleRatio);
-    if (scale > 1) {
-        // Bug-61709: Qt原因右下页边距在缩放大于100后出现失效问题，这里先用一个临时的解决办法处理
-        QImage tmpImage(previewPrinter->pageRect().size() / numberUpPrintData->scaleRatio, QImage::Format_ARGB32);
-        tmpImage.fill(Qt::white);
-        QPainter tmpPainter(&tmpImage);
-
-        // 为了保证并打缩放的清晰度 防止先缩放小再缩放大导致图像不清晰的问题 这里直接将并打内容放大 然后在统一缩小到并打大小
-        for (int c = 0; c < numberUpPrintData->previewPictures.count(); ++c) {
-            QPointF paintPoint = numberUpPrintData->paintPoints.at(c) / numberUpPrintData->scaleRatio;
-            const QPicture *pic = numberUpPrintData->previewPictures.at(c).second;
-            tmpPainter.drawPicture(paintPoint, *pic);
-        }
-
-        painter->drawImage(leftTop / numberUpPrintData->scaleRatio, tmpImage);
-    } else {
-        for (int c = 0; c < numberUpPrintData->previewPictures.count(); ++c) {
-            QPointF paintPoint = numberUpPrintData->paintPoints.at(c) / numberUpPrintData->scaleRatio;
-            const QPicture *pic = numberUpPrintData->previewPictures.at(c).second;
-            painter->drawPicture(leftTop / numberUpPrintData->scaleRatio + paintPoint, *pic);
-        }
-    }
-    painter->restore();
+    QVector<const QPicture *> pictures;
+    for (const auto &item : qAsConst(numberUpPrintData->previewPictures))
+        pictures.append(item.second);
 
-    // 绘制并打水印 此时不能再设置缩放比
-    if (!waterImage.isNull())
-        painter->drawImage(leftTop, waterImage);
+    drawMultiPage(painter, leftTop, waterImage, pictures, numberUpPrintData->paintPoints, numberUpPrintData->scaleRatio, scale, previewPrinter->pageRect().size());
 }
 
 void DPrintPreviewWidgetPrivate::print(bool printAsPicture)
@@ -511,6 +703,14 @@ void DPrintPreviewWidgetPrivate::print(bool printAsPicture)
             syncPrint(leftTopPoint, pageRect, pageVector);
         }
     }
+
+    if (isAsynPreview) {
+        // 打印时录制的页面不属于预览，恢复为当前页，同时从缓存中释放其它打印页面
+        previewPages = requestPages(currentPageNumber);
+        generatePreviewPicture();
+        if (imposition != DPrintPreviewWidget::One)
+            updateNumberUpContent();
+    }
 }
 
 void DPrintPreviewWidgetPrivate::updatePageByPagePrintVector(QVector<int> &pageVector, QList<const QPicture *> &pictures) const
@@ -706,8 +906,42 @@ QImage DPrintPreviewWidgetPrivate::generateWaterMarkImage() const
         return originImage;
     };
 
+    // 水印效果、页面大小和并打布局都没有变化时，直接使用上次生成的水印图片
+    WaterMark *wm = waterMark;
+    if (imposition != DPrintPreviewWidget::One) {
+        wm = numberUpPrintData->waterList.isEmpty() ? nullptr : numberUpPrintData->waterList.first();
+        if (wm) {
+            wm->setBoundingRect(previewPrinter->pageRect());
+            wm->setNumberUpScale(1);
+        }
+    }
+
+    QByteArray key;
+    {
+        QDataStream stream(&key, QIODevice::WriteOnly);
+        stream << int(imposition) << waterMark->itemMaxPolygon().boundingRect() << int(colorMode);
+        if (wm) {
+            // 字号在绘制时根据缩放比重新计算，不参与比较
+            QFont font = wm->font;
+            font.setPointSize(WATER_DEFAULTFONTSIZE);
+            stream << int(wm->type) << int(wm->layout) << wm->text << font << wm->color
+                   << wm->mScaleFactor << wm->rotation() << wm->opacity() << wm->itemMaxPolygon()
+                   << wm->sourceImage.cacheKey() << wm->graySourceImage.cacheKey();
+        }
+        if (imposition != DPrintPreviewWidget::One) {
+            stream << previewPrinter->pageRect() << numberUpPrintData->scaleRatio
+                   << numberUpPrintData->paintPoints.mid(0, numberUpPrintData->previewPictures.count());
+        }
+    }
+
+    if (!waterMarkImageCache.isNull() && key == waterMarkImageKey)
+        return waterMarkImageCache;
+
+    waterMarkImageKey = key;
+
     QImage waterMarkImage = drawSingleWaterMarkImage();
     if (imposition == DPrintPreviewWidget::One) {
+        waterMarkImageCache = waterMarkImage;
         return waterMarkImage;
     } else {
         const QRectF &pageRect = previewPrinter->pageRect();
@@ -737,6 +971,8 @@ QImage DPrintPreviewWidgetPrivate::generateWaterMarkImage() const
             tp.drawImage(paintPoint, singleWaterImage);
         }
         tp.end();
+
+        waterMarkImageCache = totalWaterImage;
         return totalWaterImage;
     }
 }
@@ -839,6 +1075,37 @@ void DPrintPreviewWidgetPrivate::generatePreviewPicture()
 {
     Q_Q(DPrintPreviewWidget);
 
+    if (isAsynPreview && pictureCacheEnabled) {
+        // 只录制缓存中没有的页面，翻页时已预取的页面可以直接使用
+        QVector<int> missingPages;
+        for (int page : qAsConst(previewPages)) {
+            if (!pictureCache.contains(page) && !missingPages.contains(page))
+                missingPages.append(page);
+        }
+
+        if (missingPages.isEmpty() || recordPictures(missingPages)) {
+            pictures.clear();
+            for (int page : qAsConst(previewPages)) {
+                auto it = pictureCache.find(page);
+                if (it != pictureCache.end())
+                    pictures.append(&it.value());
+            }
+
+            updatePagePictures();
+            evictPictures();
+            return;
+        }
+
+        // 录制的页面无法与页码对应，退回到每次重新录制全部页面
+        pictureCache.clear();
+        pictureCacheEnabled = false;
+        if (missingPages == previewPages) {
+            pictures = previewPrinter->getPrinterPages();
+            updatePagePictures();
+            return;
+        }
+    }
+
     previewPrinter->setPreviewMode(true);
     if (isAsynPreview) {
         Q_EMIT q->paintRequested(previewPrinter, previewPages);
@@ -847,6 +1114,103 @@ void DPrintPreviewWidgetPrivate::generatePreviewPicture()
     }
     previewPrinter->setPreviewMode(false);
     pictures = previewPrinter->getPrinterPages();
+    updatePagePictures();
+}
+
+void DPrintPreviewWidgetPrivate::updatePagePictures()
+{
+    // 异步预览时页面项只是当前 pictures 的视图，翻页后需要指向新的页面，
+    // 否则缓存中的旧页面被释放后页面项会持有悬空指针
+    if (!isAsynPreview)
+        return;
+
+    for (int i = 0; i < pages.count(); ++i) {
+        if (PageItem *pi = dynamic_cast<PageItem *>(pages.at(i)))
+            pi->setPagePicture(i < pictures.count() ? pictures.at(i) : nullptr);
+    }
+}
+
+bool DPrintPreviewWidgetPrivate::recordPictures(const QVector<int> &pageNumbers)
+{
+    Q_Q(DPrintPreviewWidget);
+
+    previewPrinter->setPreviewMode(true);
+    Q_EMIT q->paintRequested(previewPrinter, pageNumbers);
+    previewPrinter->setPreviewMode(false);
+
+    // 再次录制时打印机会释放之前的页面，这里保存一份共享数据的拷贝
+    const QList<const QPicture *> &recorded = previewPrinter->getPrinterPages();
+    if (recorded.count() != pageNumbers.count())
+        return false;
+
+    for (int i = 0; i < pageNumbers.count(); ++i)
+        pictureCache.insert(pageNumbers.at(i), *recorded.at(i));
+
+    return true;
+}
+
+void DPrintPreviewWidgetPrivate::evictPictures()
+{
+    QSet<int> keepPages;
+    for (int page : qAsConst(previewPages))
+        keepPages.insert(page);
+
+    const int count = pagesCount();
+    const int first = qMax(FIRST_PAGE, currentPageNumber - PREVIEW_PREFETCH_PAGES);
+    const int last = qMin(count, currentPageNumber + PREVIEW_PREFETCH_PAGES);
+    for (int page = first; page <= last; ++page) {
+        for (int p : requestPages(page))
+            keepPages.insert(p);
+    }
+
+    for (auto it = pictureCache.begin(); it != pictureCache.end();) {
+        if (keepPages.contains(it.key()))
+            ++it;
+        else
+            it = pictureCache.erase(it);
+    }
+}
+
+void DPrintPreviewWidgetPrivate::schedulePrefetch()
+{
+    if (!isAsynPreview || !pictureCacheEnabled)
+        return;
+
+    // 连续翻页时重新计时，等当前页绘制完成、翻页停下来后再预取
+    prefetchTimer->start();
+}
+
+void DPrintPreviewWidgetPrivate::prefetchPictures()
+{
+    if (!isAsynPreview || !pictureCacheEnabled)
+        return;
+
+    QVector<int> missingPages;
+    auto appendPage = [&](int page) {
+        if (page < FIRST_PAGE || page > pagesCount())
+            return;
+
+        for (int p : requestPages(page)) {
+            if (!pictureCache.contains(p) && !missingPages.contains(p))
+                missingPages.append(p);
+        }
+    };
+
+    // 翻页方向上预取多页，反方向只预取一页
+    for (int i = 1; i <= PREVIEW_PREFETCH_PAGES; ++i)
+        appendPage(currentPageNumber + navigationStep * i);
+    appendPage(currentPageNumber - navigationStep);
+
+    if (missingPages.isEmpty())
+        return;
+
+    if (!recordPictures(missingPages)) {
+        // 当前显示的页面都在缓存中，不受影响，只是不再使用缓存
+        pictureCacheEnabled = false;
+        return;
+    }
+
+    evictPictures();
 }
 
 void DPrintPreviewWidgetPrivate::calculateNumberPageScale()
@@ -1973,10 +2337,13 @@ void DPrintPreviewWidget::setCurrentPage(int page)
             d->pages.at(lastPage - 1)->setVisible(false);
     } else
         d->pages.first()->setVisible(false);
+    if (d->isAsynPreview)
+        d->navigationStep = page < d->currentPageNumber ? -1 : 1;
     d->setCurrentPageNumber(page);
     if (d->isAsynPreview) {
         d->previewPages = d->requestPages(page);
         d->generatePreviewPicture();
+        d->schedulePrefetch();
     }
 
     if (d->imposition != Imposition::One) {
@@ -2059,6 +2426,15 @@ void PageItem::setVisible(bool isVisible)
     QGraphicsItem::setVisible(isVisible);
 }
 
+QVariant PageItem::itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant &value)
+{
+    // 隐藏的页面不再保留灰度数据，避免翻页后所有页面的图像都驻留在内存中
+    if (change == ItemVisibleHasChanged && !value.toBool())
+        content->releaseGrayContent();
+
+    return QGraphicsItem::itemChange(change, value);
+}
+
 void ContentItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *item, QWidget *widget)
 {
     Q_UNUSED(widget);
@@ -2079,7 +2455,11 @@ void ContentItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *item,
     painter->translate(leftTopPoint);
 
     if (pwidget && (pwidget->getColorMode() == QPrinter::GrayScale)) {
-        // 图像灰度处理
+        // 图像灰度处理，灰度内容在第一次需要绘制时才生成
+        if (grayContentDirty && pagePicture) {
+            grayPicture = grayscalePaint(*pagePicture);
+            grayContentDirty = false;
+        }
         painter->drawPicture(0, 0, grayPicture);
     } else if (pwidget && (pwidget->getColorMode() == QPrinter::Color)) {
         drawNumberUpPictures(painter);
@@ -2088,7 +2468,14 @@ void ContentItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *item,
 
 void ContentItem::updateGrayContent()
 {
-    grayPicture = grayscalePaint(*pagePicture);
+    grayContentDirty = true;
+    update();
+}
+
+void ContentItem::releaseGrayContent()
+{
+    grayPicture = QPicture();
+    grayContentDirty = true;
 }
 
 void ContentItem::drawNumberUpPictures(QPainter *painter)
@@ -2147,28 +2534,14 @@ QPicture ContentItem::grayscalePaint(const QPicture &picture)
 
 QImage ContentItem::imageGrayscale(const QImage *origin)
 {
-    int w = origin->width();
-    int h = origin->height();
-    QImage iGray(w, h, QImage::Format_ARGB32);
-
-    for (int i = 0; i < w; i++) {
-        for (int j = 0; j < h; j++) {
-            QRgb pixel = origin->pixel(i, j);
-            int gray = qGray(pixel);
-            QColor color(gray, gray, gray, qAlpha(pixel));
-            iGray.setPixel(i, j, color.rgba());
-        }
-    }
-
-    return iGray;
+    return grayscaleImage(*origin);
 }
 
 void WaterMark::setImage(const QImage &img)
 {
     type = Image;
     sourceImage = img;
-    graySourceImage = img;
-    grayscale(img, graySourceImage, img.rect());
+    graySourceImage = grayscaleImage(img);
 }
 
 void WaterMark::paint(QPainter *painter, const QStyleOptionGraphicsItem *item, QWidget *widget)
@@ -2208,28 +2581,35 @@ void WaterMark::updatePicture(QPainter *painter, bool isPreview)
             break;
         }
 
-        QFontMetrics fm(font);
-        QSize textSize = fm.size(Qt::TextSingleLine, text);
-        int space = qMin(textSize.width(), textSize.height());
-        QSize spaceSize = QSize(WATER_TEXTSPACE, space) * numberUpScale * wScale;
-        QImage textImage(textSize + spaceSize, QImage::Format_ARGB32);
-        textImage.fill(Qt::transparent);
-        QPainter tp;
-        tp.begin(&textImage);
-
-        tp.setFont(font);
-        tp.setPen(color);
-        tp.setBrush(Qt::NoBrush);
-        tp.setRenderHint(QPainter::TextAntialiasing);
-        tp.drawText(textImage.rect(), Qt::AlignBottom | Qt::AlignRight, text);
-        tp.end();
+        // 平铺的文字图块只在文字、字体、颜色或缩放比改变时重新生成
+        const QString tileKey = QString("text-%1-%2-%3-%4").arg(text, font.toString()).arg(color.rgba()).arg(numberUpScale * wScale);
+        if (tileKey != tileCacheKey || tileCache.isNull()) {
+            QFontMetrics fm(font);
+            QSize textSize = fm.size(Qt::TextSingleLine, text);
+            int space = qMin(textSize.width(), textSize.height());
+            QSize spaceSize = QSize(WATER_TEXTSPACE, space) * numberUpScale * wScale;
+            QImage textImage(textSize + spaceSize, QImage::Format_ARGB32);
+            textImage.fill(Qt::transparent);
+            QPainter tp;
+            tp.begin(&textImage);
+
+            tp.setFont(font);
+            tp.setPen(color);
+            tp.setBrush(Qt::NoBrush);
+            tp.setRenderHint(QPainter::TextAntialiasing);
+            tp.drawText(textImage.rect(), Qt::AlignBottom | Qt::AlignRight, text);
+            tp.end();
+
+            tileCache = textImage;
+            tileCacheKey = tileKey;
+        }
 
         painter->save();
         painter->setRenderHint(QPainter::SmoothPixmapTransform);
         painter->setRenderHint(QPainter::Antialiasing);
         painter->setPen(Qt::NoPen);
         QBrush b;
-        b.setTextureImage(textImage);
+        b.setTextureImage(tileCache);
         painter->setBrush(b);
         painter->drawRect(twoPolygon.boundingRect());
         painter->restore();
@@ -2238,12 +2618,17 @@ void WaterMark::updatePicture(QPainter *painter, bool isPreview)
         if (sourceImage.isNull() || graySourceImage.isNull() || qFuzzyCompare(mScaleFactor, 0))
             return;
 
-        QImage img = sourceImage;
-        if (pwidget->getColorMode() == QPrinter::GrayScale) {
-            img = graySourceImage;
+        const QImage &source = (pwidget->getColorMode() == QPrinter::GrayScale) ? graySourceImage : sourceImage;
+        const int targetWidth = qRound(source.width() * mScaleFactor * numberUpScale * wScale);
+
+        // 缩放后的图片只在原图或缩放比改变时重新生成
+        const QString tileKey = QString("image-%1-%2").arg(source.cacheKey()).arg(targetWidth);
+        if (tileKey != tileCacheKey || tileCache.isNull()) {
+            tileCache = source.scaledToWidth(targetWidth);
+            tileCacheKey = tileKey;
         }
 
-        img = img.scaledToWidth(qRound(img.width() * mScaleFactor * numberUpScale * wScale));
+        const QImage img = tileCache;
         QSize size = img.size() / img.devicePixelRatio();
         int imgWidth = size.width();
         int imgHeight = size.height();
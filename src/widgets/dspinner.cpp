@@ -1,9 +1,10 @@
 #include "dspinner.h"
+#include "private/danimationclock_p.h"
 
 #include <QtMath>
 #include <QPainter>
 #include <QPainterPath>
-#include <QTimer>
+#include <QPixmapCache>
 #include <QEvent>
 
 #include <DObjectPrivate>
@@ -16,8 +17,10 @@ public:
     explicit DSpinnerPrivate(DSpinner *qq);
 
     QList<QColor> createDefaultIndicatorColorList(QColor color);
+    void paintFrame(QPainter *painter, const QRectF &rect, double degree) const;
 
-    QTimer refreshTimer;
+    int refreshInterval = 30;
+    bool playing = false;
 
     double indicatorShadowOffset = 10;
     double currentDegree = 0.0;
@@ -65,14 +68,7 @@ DSpinner::DSpinner(QWidget *parent) :
 {
     Q_D(DSpinner);
 
-    d->refreshTimer.setInterval(30);
     d->colorGroup = palette().currentColorGroup();
-
-    connect(&d->refreshTimer, &QTimer::timeout,
-    this, [ = ]() {
-        d->currentDegree += 14;
-        update();
-    });
 }
 
 DSpinner::~DSpinner()
@@ -87,7 +83,7 @@ DSpinner::~DSpinner()
 bool DSpinner::isPlaying() const
 {
     Q_D(const DSpinner);
-    return d->refreshTimer.isActive();
+    return d->playing;
 }
 
 /*!
@@ -97,7 +93,13 @@ bool DSpinner::isPlaying() const
 void DSpinner::start()
 {
     Q_D(DSpinner);
-    d->refreshTimer.start();
+    d->playing = true;
+    // 所有动画控件共用同一个时钟，隐藏时自动暂停
+    DAnimationClock::instance()->subscribe(this, d->refreshInterval, [this, d](qint64 elapsed) {
+        // 每 refreshInterval 毫秒旋转 14 度，按实际经过的时间推进
+        d->currentDegree = std::fmod(d->currentDegree + 14.0 * elapsed / d->refreshInterval, 360.0);
+        update();
+    });
 }
 
 /*!
@@ -107,7 +109,8 @@ void DSpinner::start()
 void DSpinner::stop()
 {
     Q_D(DSpinner);
-    d->refreshTimer.stop();
+    d->playing = false;
+    DAnimationClock::instance()->unsubscribe(this);
 }
 
 /*!
@@ -136,20 +139,46 @@ void DSpinner::paintEvent(QPaintEvent *)
             d->indicatorColors << d->createDefaultIndicatorColorList(palette().highlight().color());
     }
 
+    // 各组指示点颜色相同，每旋转 indicatorDegreeDelta 度画面重复一次，
+    // 因此只需缓存一个周期内的帧，相同尺寸和颜色的 DSpinner 之间共享
+    const int indicatorDegreeDelta = 360 / d->indicatorColors.count();
+    const int frameDegree = qRound(d->currentDegree) % indicatorDegreeDelta;
+    const qreal ratio = devicePixelRatioF();
+    const QString &key = QString("dtk-spinner-%1x%2-%3-%4-%5").arg(width()).arg(height())
+            .arg(palette().highlight().color().name(QColor::HexArgb)).arg(ratio).arg(frameDegree);
+    QPixmap frame;
+
+    if (!QPixmapCache::find(key, &frame)) {
+        frame = QPixmap((QSizeF(size()) * ratio).toSize());
+        frame.setDevicePixelRatio(ratio);
+        frame.fill(Qt::transparent);
+
+        QPainter framePainter(&frame);
+        d->paintFrame(&framePainter, rect(), frameDegree);
+        framePainter.end();
+
+        QPixmapCache::insert(key, frame);
+    }
+
     QPainter painter(this);
-    painter.setRenderHints(QPainter::Antialiasing);
+    painter.drawPixmap(0, 0, frame);
+}
+
+void DSpinnerPrivate::paintFrame(QPainter *painter, const QRectF &rect, double degree) const
+{
+    painter->setRenderHints(QPainter::Antialiasing);
 
-    auto degreeCurrent = d->currentDegree * 1.0;
+    auto degreeCurrent = degree;
 
-    auto center = QRectF(rect()).center();
-    auto radius = qMin(rect().width(), rect().height()) / 2.0;
+    auto center = rect.center();
+    auto radius = qMin(rect.width(), rect.height()) / 2.0;
     auto indicatorRadius = radius / 2 / 2 * 1.1;
-    auto indicatorDegreeDelta = 360 / d->indicatorColors.count();
+    auto indicatorDegreeDelta = 360 / indicatorColors.count();
 
-    for (int i = 0; i <  d->indicatorColors.count(); ++i) {
-        auto colors = d->indicatorColors.value(i);
+    for (int i = 0; i <  indicatorColors.count(); ++i) {
+        auto colors = indicatorColors.value(i);
         for (int j = 0; j < colors.count(); ++j) {
-            degreeCurrent = d->currentDegree - j * d->indicatorShadowOffset + indicatorDegreeDelta * i;
+            degreeCurrent = degree - j * indicatorShadowOffset + indicatorDegreeDelta * i;
             auto x = (radius - indicatorRadius) * qCos(qDegreesToRadians(degreeCurrent));
             auto y = (radius - indicatorRadius) * qSin(qDegreesToRadians(degreeCurrent));
 
@@ -161,7 +190,7 @@ void DSpinner::paintEvent(QPaintEvent *)
             QPainterPath path;
             path.addEllipse(rf);
 
-            painter.fillPath(path, colors.value(j));
+            painter->fillPath(path, colors.value(j));
         }
     }
 }
@@ -30,6 +30,8 @@
 #include <QGuiApplication>
 #include <QAbstractItemView>
 #include <QPainterPath>
+#include <QMutex>
+#include <qdrawutil.h>
 
 #include <qmath.h>
 #include <private/qfixed_p.h>
@@ -967,6 +969,94 @@ DStyle::DStyle()
 
 }
 
+// generatedBrush 在绘制每个列表项、按钮时都会被调用，缓存颜色的计算结果
+struct GeneratedColorKey
+{
+    quint64 base;
+    quint64 extra;
+    int state;
+    int role;
+};
+
+static inline bool operator==(const GeneratedColorKey &k1, const GeneratedColorKey &k2)
+{
+    return k1.base == k2.base && k1.extra == k2.extra && k1.state == k2.state && k1.role == k2.role;
+}
+
+static inline uint qHash(const GeneratedColorKey &key, uint seed = 0)
+{
+    return qHash(key.base, seed) ^ qHash(key.extra, seed) ^ qHash((key.state << 16) ^ key.role, seed);
+}
+
+class GeneratedColorCache
+{
+public:
+    bool find(const GeneratedColorKey &key, QColor *color)
+    {
+        QMutexLocker locker(&mutex);
+        auto it = colors.constFind(key);
+
+        if (it == colors.constEnd())
+            return false;
+
+        *color = it.value();
+        return true;
+    }
+
+    void insert(const GeneratedColorKey &key, const QColor &color)
+    {
+        QMutexLocker locker(&mutex);
+
+        // 颜色的组合有限，超出上限时说明颜色在持续变化（如动画），直接清空即可
+        if (colors.size() >= 1024)
+            colors.clear();
+
+        colors.insert(key, color);
+    }
+
+private:
+    QMutex mutex;
+    QHash<GeneratedColorKey, QColor> colors;
+};
+Q_GLOBAL_STATIC(GeneratedColorCache, _d_generatedColorCache)
+
+// 以九宫格的方式绘制纯色圆角矩形，圆角只光栅化一次并缓存，绘制时只需贴图
+static bool drawCachedRoundedRect(QPainter *pa, const QRect &rect, int radius, const QColor &color, DDrawUtils::Corners corners)
+{
+    const qreal ratio = pa->device()->devicePixelRatioF();
+    const int side = radius * 2 + 1;
+
+    // 非整数缩放时贴图的边界无法与像素对齐，区域容不下圆角或者有旋转缩放变换时也使用路径绘制
+    if (radius <= 0 || rect.width() < side || rect.height() < side
+            || !qFuzzyCompare(ratio, qRound(ratio))
+            || pa->transform().type() > QTransform::TxTranslate) {
+        return false;
+    }
+
+    const QString &key = QString("dtk-item-background-%1-%2-%3-%4")
+            .arg(color.rgba(), 8, 16).arg(radius).arg(int(corners)).arg(ratio);
+    QPixmap pixmap;
+
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = QPixmap(QSize(side, side) * qRound(ratio));
+        pixmap.setDevicePixelRatio(ratio);
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(color);
+        DDrawUtils::drawRoundedRect(&painter, QRect(0, 0, side, side), radius, radius, corners);
+        painter.end();
+
+        QPixmapCache::insert(key, pixmap);
+    }
+
+    qDrawBorderPixmap(pa, rect, QMargins(radius, radius, radius, radius), pixmap);
+
+    return true;
+}
+
 /*!
  * \~chinese \brief DStyle::drawPrimitive
  * \~chinese QStyle::drawPrimitive()
@@ -993,33 +1083,44 @@ void DStyle::drawPrimitive(const QStyle *style, DStyle::PrimitiveElement pe, con
             p->setPen(Qt::NoPen);
             p->setRenderHint(QPainter::Antialiasing);
 
+            const DDrawUtils::Corners allCorners = DDrawUtils::TopLeftCorner | DDrawUtils::TopRightCorner
+                    | DDrawUtils::BottomLeftCorner | DDrawUtils::BottomRightCorner;
+
+            // 列表中的每一项都会绘制背景，优先使用缓存的九宫格图片
+            auto drawRoundedBackground = [&](DDrawUtils::Corners corners) {
+                if (drawCachedRoundedRect(p, vopt->rect, frame_radius, color, corners))
+                    return;
+
+                if (corners == allCorners) {
+                    p->drawRoundedRect(vopt->rect, frame_radius, frame_radius);
+                } else {
+                    DDrawUtils::drawRoundedRect(p, vopt->rect, frame_radius, frame_radius, corners);
+                }
+            };
+
             if (vopt->directions != Qt::Horizontal && vopt->directions != Qt::Vertical) {
-                p->drawRoundedRect(vopt->rect, frame_radius, frame_radius);
+                drawRoundedBackground(allCorners);
                 break;
             }
 
             switch (vopt->position) {
             case DStyleOptionBackgroundGroup::OnlyOne:
-                p->drawRoundedRect(vopt->rect, frame_radius, frame_radius);
+                drawRoundedBackground(allCorners);
                 break;
             case DStyleOptionBackgroundGroup::Beginning: {
                 if (vopt->directions == Qt::Horizontal) {
-                    DDrawUtils::drawRoundedRect(p, vopt->rect, frame_radius, frame_radius,
-                                                DDrawUtils::TopLeftCorner | DDrawUtils::BottomLeftCorner);
+                    drawRoundedBackground(DDrawUtils::TopLeftCorner | DDrawUtils::BottomLeftCorner);
                 } else {
-                    DDrawUtils::drawRoundedRect(p, vopt->rect, frame_radius, frame_radius,
-                                                DDrawUtils::TopLeftCorner | DDrawUtils::TopRightCorner);
+                    drawRoundedBackground(DDrawUtils::TopLeftCorner | DDrawUtils::TopRightCorner);
                 }
 
                 break;
             }
             case DStyleOptionBackgroundGroup::End:
                 if (vopt->directions == Qt::Horizontal) {
-                    DDrawUtils::drawRoundedRect(p, vopt->rect, frame_radius, frame_radius,
-                                                DDrawUtils::TopRightCorner | DDrawUtils::BottomRightCorner);
+                    drawRoundedBackground(DDrawUtils::TopRightCorner | DDrawUtils::BottomRightCorner);
                 } else {
-                    DDrawUtils::drawRoundedRect(p, vopt->rect, frame_radius, frame_radius,
-                                                DDrawUtils::BottomLeftCorner | DDrawUtils::BottomRightCorner);
+                    drawRoundedBackground(DDrawUtils::BottomLeftCorner | DDrawUtils::BottomRightCorner);
                 }
 
                 break;
@@ -2141,7 +2242,27 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
     if (!colorNew.isValid())
         return base;
 
-    if ((flags & StyleState_Mask)  == SS_HoverState) {
+    const StateFlags state = flags & StyleState_Mask;
+
+    if (state != SS_HoverState && state != SS_PressState)
+        return base;
+
+    if (state == SS_PressState && role == QPalette::ButtonText)
+        return option->palette.highlight();
+
+    GeneratedColorKey key = {colorNew.rgba64(), 0, int(state), int(role)};
+
+    // 部分颜色还依赖于 option 中的调色板，需要一起作为键值
+    if (state == SS_HoverState && role == QPalette::ButtonText) {
+        key.extra = DGuiApplicationHelper::toColorType(option->palette);
+    } else if (state == SS_PressState && (role == QPalette::Button || role == QPalette::Light || role == QPalette::Dark)) {
+        key.extra = option->palette.highlight().color().rgba64();
+    }
+
+    if (_d_generatedColorCache->find(key, &colorNew))
+        return colorNew;
+
+    if (state == SS_HoverState) {
         switch (role) {
         case QPalette::Button:
         case QPalette::Light:
@@ -2152,7 +2273,7 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
             colorNew = adjustColor(colorNew, 0, 0, +20);
             break;
         case QPalette::ButtonText: {
-            DGuiApplicationHelper::ColorType type = DGuiApplicationHelper::toColorType(option->palette);
+            DGuiApplicationHelper::ColorType type = DGuiApplicationHelper::ColorType(key.extra);
             colorNew = adjustColor(colorNew, 0, 0, type == DGuiApplicationHelper::DarkType ? 20 : -50);
             break;
         }
@@ -2162,20 +2283,19 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
         default:
             break;
         }
-
-        return colorNew;
-    } else if ((flags & StyleState_Mask) == SS_PressState) {
-        QColor hightColor = option->palette.highlight().color();
-        hightColor.setAlphaF(0.1);
-
+    } else {
         switch (role) {
         case QPalette::Button:
         case QPalette::Light: {
+            QColor hightColor = option->palette.highlight().color();
+            hightColor.setAlphaF(0.1);
             colorNew = adjustColor(colorNew, 0, 0, -20, 0, 0, +20, 0);
             colorNew = blendColor(colorNew, hightColor);
             break;
         }
         case QPalette::Dark: {
+            QColor hightColor = option->palette.highlight().color();
+            hightColor.setAlphaF(0.1);
             colorNew = adjustColor(colorNew, 0, 0, -15, 0, 0, +20, 0);
             colorNew = blendColor(colorNew, hightColor);
             break;
@@ -2183,19 +2303,17 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
         case QPalette::Highlight:
             colorNew = adjustColor(colorNew, 0, 0, -10);
             break;
-        case QPalette::ButtonText:
-            return option->palette.highlight();
         case QPalette::HighlightedText:
             colorNew = adjustColor(colorNew, 0, 0, 0, 0, 0, 0, -40);
             break;
         default:
             break;
         }
-
-        return colorNew;
     }
 
-    return base;
+    _d_generatedColorCache->insert(key, colorNew);
+
+    return colorNew;
 }
 
 /*!
@@ -2248,7 +2366,18 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
     if (!colorNew.isValid())
         return base;
 
-    if ((flags & StyleState_Mask)  == SS_HoverState) {
+    const StateFlags state = flags & StyleState_Mask;
+
+    if (state != SS_HoverState && state != SS_PressState && state != SS_NormalState)
+        return base;
+
+    // 使用负数区分 DPalette::ColorType 和 QPalette::ColorRole
+    const GeneratedColorKey key = {colorNew.rgba64(), 0, int(state), -1 - int(type)};
+
+    if (_d_generatedColorCache->find(key, &colorNew))
+        return colorNew;
+
+    if (state == SS_HoverState) {
         switch (type) {
         case DPalette::LightLively:
             colorNew = adjustColor(colorNew, 0, 0, +30, 0, 0, 0, 0);
@@ -2269,9 +2398,7 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
         default:
             break;
         }
-
-        return colorNew;
-    } else if ((flags & StyleState_Mask) == SS_PressState) {
+    } else if (state == SS_PressState) {
         switch (type) {
         case DPalette::LightLively:
             colorNew = adjustColor(colorNew, 0, 0, -30, 0, 0, 0, 0);
@@ -2286,9 +2413,7 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
         default:
             break;
         }
-
-        return colorNew;
-    } else if ((flags & StyleState_Mask) == SS_NormalState) {
+    } else {
         switch (type) {
         case DPalette::LightLively:
             colorNew = adjustColor(colorNew, 0, 0, +40, 0, 0, 0, 0);
@@ -2299,11 +2424,11 @@ QBrush DStyle::generatedBrush(StateFlags flags, const QBrush &base, QPalette::Co
         default:
             break;
         }
-
-        return colorNew;
     }
 
-    return base;
+    _d_generatedColorCache->insert(key, colorNew);
+
+    return colorNew;
 }
 
 #if QT_CONFIG(itemviews)
@@ -2693,6 +2818,36 @@ QRect DStyle::viewItemDrawText(QPainter *p, const QStyleOptionViewItem *option,
  * \~chinese \brief DStyledIconEngine一个修改的 QIconEngine 类
 */
 
+// 无法通过函数地址区分的引擎，在 QPixmapCache 中使用引擎地址和序号区分缓存。
+// 引擎创建、修改绘制函数或图标名称时更换序号，旧的缓存不会再被命中
+class StyledIconEngineSerials
+{
+public:
+    quint64 serial(const void *engine, bool renew)
+    {
+        QMutexLocker locker(&mutex);
+
+        if (!renew) {
+            auto it = serials.constFind(engine);
+            if (it != serials.constEnd())
+                return it.value();
+        }
+
+        // 表中只保存序号，清空后各引擎会得到新的序号，只会导致缓存未命中
+        if (serials.size() >= 4096)
+            serials.clear();
+
+        return serials[engine] = ++lastSerial;
+    }
+
+private:
+    QMutex mutex;
+    QHash<const void *, quint64> serials;
+    quint64 lastSerial = 0;
+};
+
+Q_GLOBAL_STATIC(StyledIconEngineSerials, _d_styledIconEngineSerials)
+
 void DStyledIconEngine::drawIcon(const QIcon &icon, QPainter *pa, const QRectF &rect)
 {
     icon.paint(pa, rect.toRect());
@@ -2710,6 +2865,7 @@ DStyledIconEngine::DStyledIconEngine(DrawFun drawFun, const QString &iconName)
 {
     m_painterRole = DPalette::NoRole;
     m_widget = nullptr;
+    _d_styledIconEngineSerials->serial(this, true);
 }
 
 /*!
@@ -2719,6 +2875,7 @@ DStyledIconEngine::DStyledIconEngine(DrawFun drawFun, const QString &iconName)
 void DStyledIconEngine::bindDrawFun(DrawFun drawFun)
 {
     m_drawFun = drawFun;
+    _d_styledIconEngineSerials->serial(this, true);
 }
 
 /*!
@@ -2728,6 +2885,7 @@ void DStyledIconEngine::bindDrawFun(DrawFun drawFun)
 void DStyledIconEngine::setIconName(const QString &name)
 {
     m_iconName = name;
+    _d_styledIconEngineSerials->serial(this, true);
 }
 
 /*!
@@ -2736,13 +2894,44 @@ void DStyledIconEngine::setIconName(const QString &name)
  */
 QPixmap DStyledIconEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
 {
+    if (!m_drawFun)
+        return QPixmap();
+
+    // size 已经是设备像素大小，缩放比例不需要单独作为缓存的键
+    QColor color;
+
+    if (m_painterRole != QPalette::NoRole)
+        color = (m_widget ? m_widget->palette() : qApp->palette()).brush(m_painterRole).color();
+
+    const QString &key = QString("%1-%2x%3-%4-%5-%6").arg(m_iconName).arg(size.width()).arg(size.height())
+            .arg(mode).arg(state).arg(color.rgba(), 8, 16);
+
+    // DDrawUtils 中的绘制函数可以通过函数地址区分，在所有图标之间共享缓存
+    typedef void (*DrawFunPointer)(QPainter *, const QRectF &);
+    const DrawFunPointer *drawFunPointer = m_drawFun.target<DrawFunPointer>();
+    QString cacheKey;
+    QPixmap pixmap;
+
+    if (drawFunPointer) {
+        cacheKey = QString("dtk-styled-icon-%1-").arg(reinterpret_cast<quintptr>(*drawFunPointer), 0, 16) + key;
+    } else {
+        cacheKey = QString("dtk-styled-icon-engine-%1-%2-").arg(reinterpret_cast<quintptr>(this), 0, 16)
+                .arg(_d_styledIconEngineSerials->serial(this, false)) + key;
+    }
+
+    if (QPixmapCache::find(cacheKey, &pixmap))
+        return pixmap;
+
     QImage image(size, QImage::Format_ARGB32_Premultiplied);
     image.fill(Qt::transparent);
     QPainter pa(&image);
     paint(&pa, QRect(QPoint(0, 0), size), mode, state);
     pa.end();
 
-    return QPixmap::fromImage(image);
+    pixmap = QPixmap::fromImage(image);
+    QPixmapCache::insert(cacheKey, pixmap);
+
+    return pixmap;
 }
 
 /*!
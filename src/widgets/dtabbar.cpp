@@ -109,6 +109,9 @@ public:
         connect(this, &QTabBar::tabMoved, this, [this] (int from, int to) {
             tabMinimumSize.move(from, to);
             tabMaximumSize.move(from, to);
+            if (tabSizeHintCache.size() == count())
+                tabSizeHintCache.move(from, to);
+            ++styleOptionGeneration;
 
             if (dd()->validIndex(ghostTabIndex)) {
                 if (from == ghostTabIndex)
@@ -242,6 +245,9 @@ public:
     void tabLayoutChange() override;
 
     void initStyleOption(QStyleOptionTab *option, int tabIndex) const;
+    const QStyleOptionTab &cachedStyleOption(int tabIndex) const;
+    QSize cachedTabSizeHint(int tabIndex) const;
+    QRect paintTabRect(int tabIndex) const;
 
      QTabBarPrivate *dd() const;
 
@@ -323,6 +329,42 @@ public:
     QPoint dragStartPosition;
 
     int ghostTabIndex = -1;
+
+    // 绘制时使用的标签样式缓存，标签的内容和状态都未改变时不再重新计算（主要是文本的省略处理）
+    struct TabStyleOptionCache {
+        QStyleOptionTab option;
+        QRect rect;
+        QString text;
+        qint64 iconKey = 0;
+        QRgb textColor = 0;
+        bool enabled = false;
+        bool hovered = false;
+        int currentIndex = -1;
+        int pressedIndex = -1;
+        quint64 generation = 0;
+    };
+    mutable QVector<TabStyleOptionCache> tabStyleOptionCache;
+    // 影响所有标签样式的变化（如调色板、字体、布局）发生时增加
+    quint64 styleOptionGeneration = 1;
+
+    // QTabBar 每次布局都会获取所有标签的大小，缓存 QTabBar::tabSizeHint 的结果，
+    // 插入、移除标签时只需要计算变化的标签
+    struct TabSizeHintCache {
+        QSize size;
+        QString text;
+        qint64 iconKey = 0;
+        QWidget *leftWidget = nullptr;
+        QWidget *rightWidget = nullptr;
+        quint64 generation = 0;
+    };
+    mutable QVector<TabSizeHintCache> tabSizeHintCache;
+    // 影响所有标签大小的属性
+    mutable QSize sizeHintIconSize;
+    mutable int sizeHintShape = -1;
+    mutable bool sizeHintDocumentMode = false;
+    mutable Qt::TextElideMode sizeHintElideMode = Qt::ElideNone;
+    // 字体、样式或以上属性变化时增加
+    mutable quint64 sizeHintGeneration = 1;
 };
 
 void DTabBarPrivate::startDrag()
@@ -1016,6 +1058,24 @@ bool DTabBarPrivate::event(QEvent *e)
     } if (e->type() == QEvent::MouseButtonRelease && mouseEvent->button() == Qt::LeftButton) {
         mousePress = false;
     }
+
+    switch (e->type()) {
+    case QEvent::FontChange:
+    case QEvent::StyleChange:
+        ++sizeHintGeneration;
+        Q_FALLTHROUGH();
+    case QEvent::PaletteChange:
+    case QEvent::EnabledChange:
+    case QEvent::LayoutDirectionChange:
+    case QEvent::ActivationChange:
+    case QEvent::FocusIn:
+    case QEvent::FocusOut:
+        ++styleOptionGeneration;
+        break;
+    default:
+        break;
+    }
+
     return QTabBar::event(e);
 }
 
@@ -1032,7 +1092,6 @@ QSize DTabBarPrivate::minimumSizeHint() const
 
 void DTabBarPrivate::paintEvent(QPaintEvent *e)
 {
-    Q_UNUSED(e)
     D_Q(DTabBar);
 
     QTabBarPrivate *d = reinterpret_cast<QTabBarPrivate *>(qGetPtrHelper(d_ptr));
@@ -1050,17 +1109,35 @@ void DTabBarPrivate::paintEvent(QPaintEvent *e)
     if (d->dragInProgress)
         selected = d->pressedIndex;
 
-    for (int i = 0; i < d->tabList.count(); ++i)
-         optTabBase.tabBarRect |= tabRect(i);
+    // 标签是连续排列的，首尾两个标签的区域即可确定所有标签的范围
+    if (!d->tabList.isEmpty())
+        optTabBase.tabBarRect |= tabRect(0) | tabRect(d->tabList.count() - 1);
 
     optTabBase.selectedTabRect = tabRect(selected);
 
     if (d->drawBase)
         p.drawPrimitive(QStyle::PE_FrameTabBarBase, optTabBase);
 
+    const QRegion &dirtyRegion = e->region();
+    const int taboverlap = style()->pixelMetric(QStyle::PM_TabBarTabOverlap, 0, this);
+    auto needPaint = [&] (int index) {
+        const QRect &rect = paintTabRect(index);
+
+        if (vertical)
+            return dirtyRegion.intersects(rect.adjusted(0, -taboverlap, 0, taboverlap));
+
+        return dirtyRegion.intersects(rect.adjusted(-taboverlap, 0, taboverlap, 0));
+    };
+
     for (int i = 0; i < d->tabList.count(); ++i) {
-        QStyleOptionTab tab;
-        initStyleOption(&tab, i);
+        if (i == selected)
+            continue;
+
+        // 只绘制和需要刷新的区域相交的标签，鼠标悬停等变化只会刷新单个标签
+        if (!needPaint(i))
+            continue;
+
+        QStyleOptionTab tab = cachedStyleOption(i);
         // 强制让文本居中
         tab.rightButtonSize = QSize();
         if (d->paintWithOffsets && d->tabList[i].dragOffset != 0) {
@@ -1085,10 +1162,6 @@ void DTabBarPrivate::paintEvent(QPaintEvent *e)
             || (vertical && (tab.rect.bottom() < 0 || tab.rect.top() > height())))
             continue;
 
-        optTabBase.tabBarRect |= tab.rect;
-        if (i == selected)
-            continue;
-
         q->paintTab(&p, i, tab);
 
         if (i == flashTabIndex) {
@@ -1099,9 +1172,8 @@ void DTabBarPrivate::paintEvent(QPaintEvent *e)
     }
 
     // Draw the selected tab last to get it "on top"
-    if (selected >= 0) {
-        QStyleOptionTab tab;
-        initStyleOption(&tab, selected);
+    if (selected >= 0 && (d->dragInProgress || needPaint(selected))) {
+        QStyleOptionTab tab = cachedStyleOption(selected);
         // 强制让文本居中
         tab.rightButtonSize = QSize();
         if (d->paintWithOffsets && d->tabList[selected].dragOffset != 0) {
@@ -1120,7 +1192,6 @@ void DTabBarPrivate::paintEvent(QPaintEvent *e)
                 p.setOpacity(1);
             }
         } else {
-            int taboverlap = style()->pixelMetric(QStyle::PM_TabBarTabOverlap, 0, this);
             d->movingTab->setGeometry(tab.rect.adjusted(-taboverlap, 0, taboverlap, 0));
         }
     }
@@ -1299,7 +1370,8 @@ QSize DTabBarPrivate::minimumTabSizeHint(int index) const
     if (min.isValid())
         return min;
 
-    QSize size = QTabBar::tabSizeHint(index);
+    // 每次布局都会获取所有标签的最小大小，这里同样使用缓存的结果
+    QSize size = cachedTabSizeHint(index);
     const QSize &max = q->maximumTabSizeHint(index);
 
     if (max.width() > 0) {
@@ -1331,6 +1403,8 @@ void DTabBarPrivate::tabLayoutChange()
 {
     D_Q(DTabBar);
 
+    ++styleOptionGeneration;
+
     q->tabLayoutChange();
     // 更新关闭按钮的显示
     updateCloseButtonVisible();
@@ -1341,6 +1415,99 @@ void DTabBarPrivate::initStyleOption(QStyleOptionTab *option, int tabIndex) cons
     QTabBar::initStyleOption(option, tabIndex);
 }
 
+const QStyleOptionTab &DTabBarPrivate::cachedStyleOption(int tabIndex) const
+{
+    QTabBarPrivate *d = dd();
+    const QTabBarPrivate::Tab &tab = d->tabList.at(tabIndex);
+
+    if (tabStyleOptionCache.size() != d->tabList.size())
+        tabStyleOptionCache.resize(d->tabList.size());
+
+    TabStyleOptionCache &cache = tabStyleOptionCache[tabIndex];
+    const QRect &rect = tabRect(tabIndex);
+    const bool hovered = !d->dragInProgress && rect == d->hoverRect;
+    const qint64 iconKey = tab.icon.cacheKey();
+    const QRgb textColor = tab.textColor.rgba();
+
+    if (cache.generation != styleOptionGeneration
+            || cache.rect != rect
+            || cache.text != tab.text
+            || cache.iconKey != iconKey
+            || cache.textColor != textColor
+            || cache.enabled != tab.enabled
+            || cache.hovered != hovered
+            || cache.currentIndex != d->currentIndex
+            || cache.pressedIndex != d->pressedIndex) {
+        cache.option = QStyleOptionTab();
+        initStyleOption(&cache.option, tabIndex);
+        cache.rect = rect;
+        cache.text = tab.text;
+        cache.iconKey = iconKey;
+        cache.textColor = textColor;
+        cache.enabled = tab.enabled;
+        cache.hovered = hovered;
+        cache.currentIndex = d->currentIndex;
+        cache.pressedIndex = d->pressedIndex;
+        cache.generation = styleOptionGeneration;
+    }
+
+    return cache.option;
+}
+
+QSize DTabBarPrivate::cachedTabSizeHint(int tabIndex) const
+{
+    QTabBarPrivate *d = dd();
+
+    if (sizeHintIconSize != d->iconSize || sizeHintShape != d->shape
+            || sizeHintDocumentMode != d->documentMode || sizeHintElideMode != d->elideMode) {
+        sizeHintIconSize = d->iconSize;
+        sizeHintShape = d->shape;
+        sizeHintDocumentMode = d->documentMode;
+        sizeHintElideMode = d->elideMode;
+        ++sizeHintGeneration;
+    }
+
+    // 子类重写 tabInserted 等函数时可能不会同步缓存，此时全部重新计算
+    if (tabSizeHintCache.size() != d->tabList.size()) {
+        tabSizeHintCache.fill(TabSizeHintCache(), d->tabList.size());
+    }
+
+    const QTabBarPrivate::Tab &tab = d->tabList.at(tabIndex);
+    TabSizeHintCache &cache = tabSizeHintCache[tabIndex];
+    const qint64 iconKey = tab.icon.cacheKey();
+
+    if (cache.generation != sizeHintGeneration
+            || cache.text != tab.text
+            || cache.iconKey != iconKey
+            || cache.leftWidget != tab.leftWidget
+            || cache.rightWidget != tab.rightWidget) {
+        cache.size = QTabBar::tabSizeHint(tabIndex);
+        cache.text = tab.text;
+        cache.iconKey = iconKey;
+        cache.leftWidget = tab.leftWidget;
+        cache.rightWidget = tab.rightWidget;
+        cache.generation = sizeHintGeneration;
+    }
+
+    return cache.size;
+}
+
+QRect DTabBarPrivate::paintTabRect(int tabIndex) const
+{
+    QTabBarPrivate *d = dd();
+    QRect rect = tabRect(tabIndex);
+
+    if (d->paintWithOffsets && d->tabList[tabIndex].dragOffset != 0) {
+        if (verticalTabs(d->shape)) {
+            rect.moveTop(rect.y() + d->tabList[tabIndex].dragOffset);
+        } else {
+            rect.moveLeft(rect.x() + d->tabList[tabIndex].dragOffset);
+        }
+    }
+
+    return rect;
+}
+
 QTabBarPrivate *DTabBarPrivate::dd() const
 {
     return reinterpret_cast<QTabBarPrivate *>(qGetPtrHelper(d_ptr));
@@ -2155,6 +2322,9 @@ void DTabBar::tabInserted(int index)
     d->tabMaximumSize.insert(index, QSize());
     d->tabMinimumSize.insert(index, QSize());
 
+    if (d->tabSizeHintCache.size() == count() - 1)
+        d->tabSizeHintCache.insert(index, DTabBarPrivate::TabSizeHintCache());
+
     d->QTabBar::tabInserted(index);
 
     Q_EMIT tabIsInserted(index);
@@ -2174,6 +2344,9 @@ void DTabBar::tabRemoved(int index)
     d->tabMaximumSize.removeAt(index);
     d->tabMinimumSize.removeAt(index);
 
+    if (d->tabSizeHintCache.size() == count() + 1)
+        d->tabSizeHintCache.removeAt(index);
+
     d->QTabBar::tabRemoved(index);
 
     Q_EMIT tabIsRemoved(index);
@@ -2183,7 +2356,7 @@ QSize DTabBar::tabSizeHint(int index) const
 {
     D_DC(DTabBar);
 
-    QSize size = d->QTabBar::tabSizeHint(index);
+    QSize size = d->cachedTabSizeHint(index);
 
     QTabBarPrivate *dd = reinterpret_cast<QTabBarPrivate *>(qGetPtrHelper(d->d_ptr));
     bool is_vertical = verticalTabs(dd->shape);
@@ -21,6 +21,8 @@
 #include <QWidget>
 #include <QStyle>
 #include <QStyleFactory>
+#include <QPointer>
+#include <QTimer>
 
 #include <DObjectPrivate>
 
@@ -225,6 +227,16 @@ class DThemeManagerPrivate : public DCORE_NAMESPACE::DObjectPrivate
 
     QString themeName;
     QMap<QWidget *, QMap<QString, QString> > watchedDynamicProperties;
+    // 记录监听的动态属性的值，值未改变时不需要刷新样式
+    QMap<QWidget *, QVariantMap> dynamicPropertyValues;
+
+    // 主题文件都在资源文件中，内容不会改变，按(主题, 类名)对应的路径缓存
+    mutable QHash<QString, QString> qssCache;
+    mutable QHash<QString, bool> themeFileCache;
+
+    // 等待刷新样式的控件，在下一次事件循环时统一处理
+    QHash<QWidget *, QPointer<QWidget>> pendingRepolish;
+    bool repolishScheduled = false;
 
 public:
     DThemeManagerPrivate(DThemeManager *qq)
@@ -232,6 +244,12 @@ public:
 
     QString getQssContent(const QString &themeURL) const
     {
+        auto it = qssCache.constFind(themeURL);
+
+        if (it != qssCache.constEnd()) {
+            return it.value();
+        }
+
         QString qss;
         QFile themeFile(themeURL);
         if (themeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -241,13 +259,56 @@ public:
             /// !!! if do not privode qss file, do not register it!!!
             qWarning() << "open qss file failed" << themeURL << themeFile.errorString();
         }
+
+        qssCache.insert(themeURL, qss);
+
         return qss;
     }
 
     bool themeFileExist(const QString &filename) const
     {
+        auto it = themeFileCache.constFind(filename);
+
+        if (it != themeFileCache.constEnd()) {
+            return it.value();
+        }
+
         QFileInfo fi(filename);
-        return  fi.exists();
+        bool exists = fi.exists();
+        themeFileCache.insert(filename, exists);
+
+        return exists;
+    }
+
+    void requestRepolish(QWidget *widget)
+    {
+        D_Q(DThemeManager);
+
+        pendingRepolish[widget] = widget;
+
+        if (repolishScheduled) {
+            return;
+        }
+
+        repolishScheduled = true;
+        QTimer::singleShot(0, q, [this] {
+            repolishScheduled = false;
+
+            const auto widgets = pendingRepolish;
+            pendingRepolish.clear();
+
+            for (const QPointer<QWidget> &widget : widgets) {
+                if (!widget) {
+                    continue;
+                }
+
+                // 重新设置样式表使 Qt 按照最新的属性值匹配选择器
+                widget->setStyleSheet(widget->styleSheet());
+                widget->style()->unpolish(widget);
+                widget->style()->polish(widget);
+                widget->update();
+            }
+        });
     }
 
     inline QString themeURL(const QString &themename, const QString &filename) const
@@ -369,8 +430,13 @@ public:
             }
             dtm->d_func()->watchedDynamicProperties.insert(widget, dynamicProperties);
 
+            for (auto &prop : dynamicProperties.keys()) {
+                dtm->d_func()->dynamicPropertyValues[widget].insert(prop, widget->property(prop.toLatin1().constData()));
+            }
+
             dtm->connect(widget, &QObject::destroyed, dtm, [ = ]() {
                 dtm->d_func()->watchedDynamicProperties.remove(widget);
+                dtm->d_func()->dynamicPropertyValues.remove(widget);
             });
         }
     }
@@ -601,9 +667,11 @@ void DThemeManager::registerWidget(QWidget *widget, const QString &filename, con
  */
 void DThemeManager::updateQss()
 {
+    D_D(DThemeManager);
+
     QWidget *w = qobject_cast<QWidget *>(sender());
     if (w) {
-        w->setStyleSheet(w->styleSheet());
+        d->requestRepolish(w);
     }
 }
 
@@ -634,10 +702,15 @@ bool DThemeManager::eventFilter(QObject *watched, QEvent *event)
     auto props = d->watchedDynamicProperties.value(widget);
     auto propName = QString::fromLatin1(propEvent->propertyName().data());
     if (props.contains(propName) && widget) {
-        widget->setStyleSheet(widget->styleSheet());
-        widget->style()->unpolish(widget);
-        widget->style()->polish(widget);
-        widget->update();
+        QVariantMap &values = d->dynamicPropertyValues[widget];
+        const QVariant &value = widget->property(propEvent->propertyName().constData());
+
+        // 属性值没有变化时无需刷新样式
+        auto it = values.find(propName);
+        if (it == values.end() || it.value() != value) {
+            values.insert(propName, value);
+            d->requestRepolish(widget);
+        }
     }
 
     return QObject::eventFilter(watched, event);
@@ -115,6 +115,18 @@ bool DTickEffect::eventFilter(QObject *watched, QEvent *event)
         d->initDirection();
     }
 
+    // 控件隐藏时暂停动画，不再占用 Qt 的动画定时器
+    if (watched == d->content && event->type() == QEvent::Hide
+            && d->runAnimation->state() == QVariantAnimation::Running) {
+        d->runAnimation->pause();
+        d->pausedByHide = true;
+    }
+
+    if (watched == d->content && event->type() == QEvent::Show && d->pausedByHide) {
+        d->runAnimation->resume();
+        d->pausedByHide = false;
+    }
+
     return QGraphicsEffect::eventFilter(watched, event);
 }
 
@@ -126,6 +138,7 @@ void DTickEffect::play()
 {
     D_D(DTickEffect);
 
+    d->pausedByHide = false;
     d->runAnimation->start();
 
     Q_EMIT stateChanged();
@@ -139,6 +152,7 @@ void DTickEffect::stop()
 {
     D_D(DTickEffect);
 
+    d->pausedByHide = false;
     d->runAnimation->stop();
 
     Q_EMIT stateChanged();
@@ -152,6 +166,7 @@ void DTickEffect::pause()
 {
     D_D(DTickEffect);
 
+    d->pausedByHide = false;
     d->runAnimation->pause();
 
     Q_EMIT stateChanged();
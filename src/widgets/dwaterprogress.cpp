@@ -16,9 +16,9 @@
  */
 
 #include "dwaterprogress.h"
+#include "private/danimationclock_p.h"
 
 #include <QtMath>
-#include <QTimer>
 #include <QPainter>
 #include <QPainterPath>
 #include <QGraphicsDropShadowEffect>
@@ -58,11 +58,23 @@ public:
     void initUI();
     void setValue(int v);
     void paint(QPainter *p);
+    void updateStaticLayers(const QSize &sz);
+    void updateTextImage(const QSize &sz, const QFont &font);
+    void clearCache();
+    bool isObscured() const;
+    void advance(qint64 elapsed);
 
     QImage waterFrontImage;
     QImage waterBackImage;
+    // 不随动画变化的图层，只在尺寸、字体、调色板变化时重新生成
+    QImage backgroundImage;
+    QImage maskImage;
+    QImage textImage;
+    QString textImageText;
+    // 每帧复用的绘制缓冲区
+    QImage waterImage;
+    QImage contentImage;
     QString progressText;
-    QTimer *timer = Q_NULLPTR;
     QList<Pop> pops;
 
     int     interval = 33;
@@ -130,8 +142,11 @@ int DWaterProgress::value() const
  */
 void DWaterProgress::start()
 {
-    D_DC(DWaterProgress);
-    d->timer->start();
+    D_D(DWaterProgress);
+    // 所有动画控件共用同一个时钟，隐藏时自动暂停
+    DAnimationClock::instance()->subscribe(this, d->interval, [d](qint64 elapsed) {
+        d->advance(elapsed);
+    });
 }
 
 /*!
@@ -140,8 +155,7 @@ void DWaterProgress::start()
  */
 void DWaterProgress::stop()
 {
-    D_DC(DWaterProgress);
-    d->timer->stop();
+    DAnimationClock::instance()->unsubscribe(this);
 }
 
 /*!
@@ -169,6 +183,7 @@ void DWaterProgress::setTextVisible(bool visible)
 {
     D_D(DWaterProgress);
     d->textVisible = visible;
+    update();
 }
 
 void DWaterProgress::paintEvent(QPaintEvent *)
@@ -180,15 +195,30 @@ void DWaterProgress::paintEvent(QPaintEvent *)
 
 void DWaterProgress::changeEvent(QEvent *e)
 {
-    if (e->type() == QEvent::PaletteChange) {
+    if (e->type() == QEvent::PaletteChange || e->type() == QEvent::FontChange) {
         D_D(DWaterProgress);
-        d->waterBackImage = QImage();
-        d->waterFrontImage = QImage();
+        d->clearCache();
     }
 
     return QWidget::changeEvent(e);
 }
 
+void DWaterProgressPrivate::clearCache()
+{
+    waterBackImage = QImage();
+    waterFrontImage = QImage();
+    backgroundImage = QImage();
+    maskImage = QImage();
+    textImage = QImage();
+}
+
+bool DWaterProgressPrivate::isObscured() const
+{
+    D_QC(DWaterProgress);
+
+    return q->visibleRegion().isEmpty();
+}
+
 void DWaterProgressPrivate::resizePixmap(QSize sz)
 {
     // resize water;
@@ -221,95 +251,198 @@ void DWaterProgressPrivate::initUI()
 
     value = 0;
 
-    timer = new QTimer(q);
-    timer->setInterval(interval);
     resizePixmap(q->size());
     frontXOffset = q->width();
     backXOffset = 0;
+}
 
-    q->connect(timer, &QTimer::timeout, q, [ = ] {
-        // interval can not be zero, and limit to 1
-        interval = (interval < 1) ? 1 : interval;
+void DWaterProgressPrivate::advance(qint64 elapsed)
+{
+    D_Q(DWaterProgress);
 
-        // move 60% per second
-        double frontXDeta = 40.0 / (1000.0 / interval);
-        // move 90% per second
-        double backXDeta = 60.0 / (1000.0 / interval);
+    // 被完全遮挡时不需要推进动画
+    if (isObscured())
+        return;
 
-        int canvasWidth = static_cast<int>(q->width() * q->devicePixelRatioF());
-        frontXOffset -= frontXDeta *canvasWidth / 100;
-        backXOffset += backXDeta *canvasWidth / 100;
+    // 按实际经过的时间推进，帧率受限时动画速度保持不变
+    const double seconds = qMax<qint64>(1, elapsed) / 1000.0;
 
-        if (frontXOffset > canvasWidth)
-        {
-            frontXOffset = canvasWidth;
-        }
-        if (frontXOffset < - (waterFrontImage.width() - canvasWidth))
-        {
-            frontXOffset = canvasWidth;
-        }
+    // move 60% per second
+    double frontXDeta = 40.0 * seconds;
+    // move 90% per second
+    double backXDeta = 60.0 * seconds;
 
-        if (backXOffset > waterBackImage.width())
-        {
-            backXOffset = 0;
-        }
+    int canvasWidth = static_cast<int>(q->width() * q->devicePixelRatioF());
+    frontXOffset -= frontXDeta *canvasWidth / 100;
+    backXOffset += backXDeta *canvasWidth / 100;
+
+    if (frontXOffset > canvasWidth)
+    {
+        frontXOffset = canvasWidth;
+    }
+    if (frontXOffset < - (waterFrontImage.width() - canvasWidth))
+    {
+        frontXOffset = canvasWidth;
+    }
 
-        // update pop
-        // move 25% per second default
-        double speed = 25 / (1000.0 / interval) /** 100 / q->height()*/;
-        for (auto &pop : pops)
-        {
-            // yOffset 0 ~ 100;
-            pop.yOffset += speed * pop.ySpeed;
-            if (pop.yOffset < 0) {
-            }
-            if (pop.yOffset > value) {
-                pop.yOffset = 0;
-            }
-            pop.xOffset = qSin((pop.yOffset / 100) * 2 * 3.14) * 18 * pop.xSpeed + 50;
+    if (backXOffset > waterBackImage.width())
+    {
+        backXOffset = 0;
+    }
+
+    // update pop
+    // move 25% per second default
+    double speed = 25 * seconds /** 100 / q->height()*/;
+    for (auto &pop : pops)
+    {
+        // yOffset 0 ~ 100;
+        pop.yOffset += speed * pop.ySpeed;
+        if (pop.yOffset < 0) {
         }
-        q->update();
-    });
+        if (pop.yOffset > value) {
+            pop.yOffset = 0;
+        }
+        pop.xOffset = qSin((pop.yOffset / 100) * 2 * 3.14) * 18 * pop.xSpeed + 50;
+    }
+    q->update();
 }
 
 void DWaterProgressPrivate::setValue(int v)
 {
+    D_Q(DWaterProgress);
+
     value = v;
     progressText = QString("%1").arg(v);
+    q->update();
+}
+
+void DWaterProgressPrivate::updateStaticLayers(const QSize &sz)
+{
+    if (backgroundImage.size() != sz) {
+        backgroundImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+        backgroundImage.fill(Qt::transparent);
+
+        QPainter painter(&backgroundImage);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        QPointF pointStart(sz.width() / 2, 0);
+        QPointF pointEnd(sz.width() / 2, sz.height());
+        QLinearGradient linear(pointStart, pointEnd);
+        QColor startColor("#1F08FF");
+        startColor.setAlphaF(1);
+        QColor endColor("#50FFF7");
+        endColor.setAlphaF(0.28);
+        linear.setColorAt(0, startColor);
+        linear.setColorAt(1, endColor);
+        linear.setSpread(QGradient::PadSpread);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(linear);
+        painter.drawEllipse(backgroundImage.rect().center(), sz.width() / 2 + 1, sz.height() / 2  + 1);
+    }
+
+    if (maskImage.size() != sz) {
+        maskImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+        maskImage.fill(Qt::transparent);
+
+        QPainterPath path;
+        path.addEllipse(QRectF(0, 0, sz.width(), sz.height()));
+        QPainter painter(&maskImage);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.fillPath(path, QBrush(Qt::white));
+    }
+
+    if (waterImage.size() != sz)
+        waterImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+
+    if (contentImage.size() != sz)
+        contentImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+}
+
+void DWaterProgressPrivate::updateTextImage(const QSize &sz, const QFont &baseFont)
+{
+    if (textImage.size() == sz && textImageText == progressText)
+        return;
+
+    textImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+    textImage.fill(Qt::transparent);
+    textImageText = progressText;
+
+    QPainter textPainter(&textImage);
+    textPainter.setRenderHint(QPainter::Antialiasing);
+
+    const QRectF rect(0, 0, sz.width(), sz.height());
+    auto font = baseFont;
+
+    QRect rectValue;
+    QSize fontTextSize;
+    int actual_width;
+    int actual_height;
+    if (progressText == "100") {
+        font.setPixelSize(sz.height() * 35 / 100);
+        textPainter.setFont(font);
+
+        fontTextSize = QFontMetrics(font).size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
+        int design_width = sz.width() * 60 / 100;
+        int design_height = sz.height() * 35 / 100;
+        actual_width = qMax(fontTextSize.width(), design_width);
+        actual_height = qMax(fontTextSize.height(), design_height);
+
+        rectValue.setWidth(actual_width);
+        rectValue.setHeight(actual_height);
+        rectValue.moveCenter(rect.center().toPoint());
+        textPainter.setPen(Qt::white);
+        textPainter.drawText(rectValue, Qt::AlignCenter, progressText);
+
+    } else {
+        font.setPixelSize(sz.height() * 40 / 100);
+        textPainter.setFont(font);
+
+        QFontMetrics numberFontMetrics(font);
+        fontTextSize = numberFontMetrics.size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
+        int design_width = sz.width() * 45 / 100;
+        int design_height = sz.height() * 40 / 100;
+        actual_width = qMax(fontTextSize.width(), design_width);
+        actual_height = qMax(fontTextSize.height(), design_height);
+
+        rectValue.setWidth(actual_width);
+        rectValue.setHeight(actual_height);
+        rectValue.moveCenter(rect.center().toPoint());
+        rectValue.moveLeft(rect.left() + rect.width() * 0.45 * 0.5);
+
+        textPainter.setPen(Qt::white);
+        textPainter.drawText(rectValue, Qt::AlignCenter, progressText);
+        font.setPixelSize(font.pixelSize() / 2);
+        textPainter.setFont(font);
+
+        QFontMetrics ratioFontMetrics(font);
+        design_height = rect.height() * 20 / 100;
+        actual_height = qMax(ratioFontMetrics.height(), design_height);
+        int descent_diff = numberFontMetrics.descent() - ratioFontMetrics.descent();
+
+        QRect rectPerent(QPoint(rectValue.right(), rectValue.bottom() - descent_diff - actual_height),
+                         QPoint(rectValue.right() + rect.width() * 20 / 100, rectValue.bottom() - descent_diff));
+
+        textPainter.drawText(rectPerent, Qt::AlignCenter, "%");
+    }
 }
 
 void DWaterProgressPrivate::paint(QPainter *p)
 {
     D_Q(DWaterProgress);
-    p->setRenderHint(QPainter::Antialiasing);
 
     qreal pixelRatio = q->devicePixelRatioF();
-    QRectF rect = QRectF(0, 0, q->width() * pixelRatio, q->height() * pixelRatio);
     QSize sz = QSizeF(q->width() * pixelRatio, q->height() * pixelRatio).toSize();
 
     resizePixmap(sz);
+    updateStaticLayers(sz);
 
-    int yOffset = rect.toRect().topLeft().y() + (100 - value - 10)  * sz.height() / 100;
+    int yOffset = (100 - value - 10)  * sz.height() / 100;
 
     // draw water
-    QImage waterImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
     QPainter waterPinter(&waterImage);
     waterPinter.setRenderHint(QPainter::Antialiasing);
     waterPinter.setCompositionMode(QPainter::CompositionMode_Source);
-
-    QPointF pointStart(sz.width() / 2, 0);
-    QPointF pointEnd(sz.width() / 2, sz.height());
-    QLinearGradient linear(pointStart, pointEnd);
-    QColor startColor("#1F08FF");
-    startColor.setAlphaF(1);
-    QColor endColor("#50FFF7");
-    endColor.setAlphaF(0.28);
-    linear.setColorAt(0, startColor);
-    linear.setColorAt(1, endColor);
-    linear.setSpread(QGradient::PadSpread);
-    waterPinter.setPen(Qt::NoPen);
-    waterPinter.setBrush(linear);
-    waterPinter.drawEllipse(waterImage.rect().center(), sz.width() / 2 + 1, sz.height() / 2  + 1);
+    waterPinter.drawImage(0, 0, backgroundImage);
 
     waterPinter.setCompositionMode(QPainter::CompositionMode_SourceOver);
     waterPinter.drawImage(static_cast<int>(backXOffset), yOffset, waterBackImage);
@@ -329,84 +462,18 @@ void DWaterProgressPrivate::paint(QPainter *p)
     }
 
     if (textVisible) {
-        auto font = waterPinter.font();
-
-        QRect rectValue;
-        QSize fontTextSize;
-        int actual_width;
-        int actual_height;
-        if (progressText == "100") {
-            font.setPixelSize(sz.height() * 35 / 100);
-            waterPinter.setFont(font);
-
-            fontTextSize = QFontMetrics(font).size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
-            int design_width = sz.width() * 60 / 100;
-            int design_height = sz.height() * 35 / 100;
-            actual_width = qMax(fontTextSize.width(), design_width);
-            actual_height = qMax(fontTextSize.height(), design_height);
-
-            rectValue.setWidth(actual_width);
-            rectValue.setHeight(actual_height);
-            rectValue.moveCenter(rect.center().toPoint());
-            waterPinter.setPen(Qt::white);
-            waterPinter.drawText(rectValue, Qt::AlignCenter, progressText);
-
-        } else {
-            font.setPixelSize(sz.height() * 40 / 100);
-            waterPinter.setFont(font);
-
-            QFontMetrics numberFontMetrics(font);
-            fontTextSize = numberFontMetrics.size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
-            int design_width = sz.width() * 45 / 100;
-            int design_height = sz.height() * 40 / 100;
-            actual_width = qMax(fontTextSize.width(), design_width);
-            actual_height = qMax(fontTextSize.height(), design_height);
-
-            rectValue.setWidth(actual_width);
-            rectValue.setHeight(actual_height);
-            rectValue.moveCenter(rect.center().toPoint());
-            rectValue.moveLeft(rect.left() + rect.width() * 0.45 * 0.5);
-
-            waterPinter.setPen(Qt::white);
-            waterPinter.drawText(rectValue, Qt::AlignCenter, progressText);
-            font.setPixelSize(font.pixelSize() / 2);
-            waterPinter.setFont(font);
-
-            QFontMetrics ratioFontMetrics(font);
-            design_height = rect.height() * 20 / 100;
-            actual_height = qMax(ratioFontMetrics.height(), design_height);
-            int descent_diff = numberFontMetrics.descent() - ratioFontMetrics.descent();
-
-            QRect rectPerent(QPoint(rectValue.right(), rectValue.bottom() - descent_diff - actual_height),
-                             QPoint(rectValue.right() + rect.width() * 20 / 100, rectValue.bottom() - descent_diff));
-
-            waterPinter.drawText(rectPerent, Qt::AlignCenter, "%");
-        }
+        updateTextImage(sz, waterPinter.font());
+        waterPinter.drawImage(0, 0, textImage);
     }
     waterPinter.end();
 
-    QPixmap maskPixmap(sz);
-    maskPixmap.fill(Qt::transparent);
-    QPainterPath path;
-    path.addEllipse(QRectF(0, 0, sz.width(), sz.height()));
-    QPainter maskPainter(&maskPixmap);
-    maskPainter.setRenderHint(QPainter::Antialiasing);
-    maskPainter.setPen(QPen(Qt::white, 1));
-    maskPainter.fillPath(path, QBrush(Qt::white));
-
-    QPainter::CompositionMode mode = QPainter::CompositionMode_SourceIn;
-    QImage contentImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
     QPainter contentPainter(&contentImage);
     contentPainter.setCompositionMode(QPainter::CompositionMode_Source);
-    contentPainter.fillRect(contentImage.rect(), Qt::transparent);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-    contentPainter.drawImage(0, 0, maskPixmap.toImage());
-    contentPainter.setCompositionMode(mode);
+    contentPainter.drawImage(0, 0, maskImage);
+    contentPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
     contentPainter.drawImage(0, 0, waterImage);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_DestinationOver);
     contentPainter.end();
 
-    contentImage.setDevicePixelRatio(pixelRatio);
     p->drawImage(q->rect(), contentImage);
 }
 
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2021 ~ 2021 Deepin Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "danimationclock_p.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWidget>
+#include <QEvent>
+
+DWIDGET_BEGIN_NAMESPACE
+
+// 无法获取屏幕刷新率时使用的唤醒间隔，约为 60 帧每秒
+static const int DefaultFrameInterval = 16;
+
+// 不跟随 qApp 销毁，比应用对象存在更久的控件仍然可以取消订阅
+Q_GLOBAL_STATIC(DAnimationClock, _d_animationClock)
+
+DAnimationClock::DAnimationClock(QObject *parent)
+    : QObject(parent)
+{
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &DAnimationClock::tick);
+    clock.start();
+}
+
+DAnimationClock *DAnimationClock::instance()
+{
+    return _d_animationClock;
+}
+
+/*!
+ * \brief DAnimationClock::subscribe 每隔 \a interval 毫秒调用一次 \a callback
+ * 同一个 \a receiver 重复订阅时会替换之前的设置，\a receiver 销毁时自动取消订阅。
+ */
+void DAnimationClock::subscribe(QObject *receiver, int interval, Callback callback)
+{
+    if (!subscribers.contains(receiver)) {
+        connect(receiver, &QObject::destroyed, this, &DAnimationClock::unsubscribe);
+        receiver->installEventFilter(this);
+    }
+
+    subscribers.insert(receiver, Subscriber {qMax(1, interval), clock.elapsed(), callback, isSuspended(receiver)});
+    updateTimerInterval();
+}
+
+void DAnimationClock::unsubscribe(QObject *receiver)
+{
+    if (!subscribers.remove(receiver))
+        return;
+
+    disconnect(receiver, &QObject::destroyed, this, &DAnimationClock::unsubscribe);
+    receiver->removeEventFilter(this);
+    updateTimerInterval();
+}
+
+bool DAnimationClock::isSubscribed(QObject *receiver) const
+{
+    return subscribers.contains(receiver);
+}
+
+/*!
+ * \brief DAnimationClock::setMaximumFrameRate 限制所有订阅者的最高刷新帧率
+ * 用于低功耗模式，\a fps 小于等于 0 时不做限制，以屏幕刷新率为准。
+ */
+void DAnimationClock::setMaximumFrameRate(int fps)
+{
+    if (maxFrameRate == fps)
+        return;
+
+    maxFrameRate = qMax(0, fps);
+    updateTimerInterval();
+}
+
+int DAnimationClock::maximumFrameRate() const
+{
+    return maxFrameRate;
+}
+
+int DAnimationClock::frameInterval() const
+{
+    int interval = DefaultFrameInterval;
+
+    if (QScreen *screen = QGuiApplication::primaryScreen()) {
+        if (screen->refreshRate() > 1)
+            interval = qMax(1, qRound(1000 / screen->refreshRate()));
+    }
+
+    if (maxFrameRate > 0)
+        interval = qMax(interval, 1000 / maxFrameRate);
+
+    return interval;
+}
+
+bool DAnimationClock::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show || event->type() == QEvent::Hide) {
+        auto it = subscribers.find(watched);
+
+        if (it != subscribers.end()) {
+            it->suspended = isSuspended(watched);
+            // 恢复时从当前时间重新计时，避免立即跳过多帧
+            it->lastTime = clock.elapsed();
+            updateTimerInterval();
+        }
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+bool DAnimationClock::isSuspended(QObject *receiver)
+{
+    QWidget *widget = qobject_cast<QWidget *>(receiver);
+
+    return widget && !widget->isVisible();
+}
+
+void DAnimationClock::updateTimerInterval()
+{
+    int interval = 0;
+
+    for (const Subscriber &subscriber : subscribers) {
+        if (subscriber.suspended)
+            continue;
+
+        interval = interval > 0 ? qMin(interval, subscriber.interval) : subscriber.interval;
+    }
+
+    // 没有需要刷新的订阅者时停止定时器
+    if (interval <= 0) {
+        timer.stop();
+        return;
+    }
+
+    // 唤醒间隔不小于一帧的时间
+    interval = qMax(frameInterval(), interval);
+
+    if (timer.interval() != interval || !timer.isActive())
+        timer.start(interval);
+}
+
+void DAnimationClock::tick()
+{
+    const qint64 now = clock.elapsed();
+    // 允许提前半个唤醒间隔触发，避免因为定时器抖动而推迟一整个周期
+    const qint64 tolerance = timer.interval() / 2;
+    const int minInterval = maxFrameRate > 0 ? 1000 / maxFrameRate : 0;
+
+    // 回调中可能会增删订阅者
+    const QList<QObject *> receivers = subscribers.keys();
+
+    for (QObject *receiver : receivers) {
+        auto it = subscribers.find(receiver);
+
+        if (it == subscribers.end() || it->suspended)
+            continue;
+
+        if (now - it->lastTime + tolerance < qMax(it->interval, minInterval))
+            continue;
+
+        // 所在窗口最小化时不需要刷新，恢复后从当前时间重新计时
+        if (QWidget *widget = qobject_cast<QWidget *>(receiver)) {
+            if (widget->window()->isMinimized()) {
+                it->lastTime = now;
+                continue;
+            }
+        }
+
+        const qint64 elapsed = now - it->lastTime;
+        it->lastTime = now;
+        Callback callback = it->callback;
+        callback(elapsed);
+    }
+}
+
+DWIDGET_END_NAMESPACE
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2021 ~ 2021 Deepin Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DANIMATIONCLOCK_P_H
+#define DANIMATIONCLOCK_P_H
+
+#include <dtkwidget_global.h>
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <functional>
+
+DWIDGET_BEGIN_NAMESPACE
+
+// 所有帧动画共用的时钟，多个订阅者只使用同一个定时器唤醒，
+// 唤醒频率与屏幕刷新率对齐，订阅者为隐藏的控件时自动暂停
+class DAnimationClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    // elapsed 为距离上一次回调经过的毫秒数，帧率受限或唤醒被合并时会大于订阅的间隔
+    typedef std::function<void(qint64 elapsed)> Callback;
+
+    explicit DAnimationClock(QObject *parent = nullptr);
+
+    static DAnimationClock *instance();
+
+    void subscribe(QObject *receiver, int interval, Callback callback);
+    void unsubscribe(QObject *receiver);
+    bool isSubscribed(QObject *receiver) const;
+
+    int maximumFrameRate() const;
+    void setMaximumFrameRate(int fps);
+    int frameInterval() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    static bool isSuspended(QObject *receiver);
+    void updateTimerInterval();
+    void tick();
+
+    struct Subscriber
+    {
+        int interval;
+        qint64 lastTime;
+        Callback callback;
+        bool suspended;
+    };
+
+    QHash<QObject *, Subscriber> subscribers;
+    int maxFrameRate = 0;
+    QTimer timer;
+    QElapsedTimer clock;
+};
+
+DWIDGET_END_NAMESPACE
+
+#endif // DANIMATIONCLOCK_P_H
@@ -24,6 +24,8 @@
 #include <DObjectPrivate>
 
 #include <QPointer>
+#include <QPainterPath>
+#include <QPixmap>
 
 DGUI_USE_NAMESPACE
 DWIDGET_BEGIN_NAMESPACE
@@ -54,6 +56,7 @@ public:
     void horizontalMove(int x, int y);
 
     void updateClipPath();
+    const QPainterPath &borderPath();
 
     bool radiusEnabled();
 
@@ -84,6 +87,37 @@ public:
     DWindowManagerHelper *m_wmHelper;
     bool leftRightRadius = false;
     bool radiusArrowStyleEnable = false;
+
+    // 边框路径的缓存，以及影响路径的所有参数
+    struct BorderPathKey {
+        QSize size;
+        int direction = -1;
+        int arrowX = 0;
+        int arrowY = 0;
+        int arrowWidth = 0;
+        int arrowHeight = 0;
+        int radius = 0;
+        int margin = 0;
+        int floatMode = 0;
+        qreal shadowBlurRadius = 0;
+        qreal shadowDistance = 0;
+        bool hasHandle = false;
+        bool radiusEnabled = false;
+        bool leftRightRadius = false;
+        bool radiusArrowStyle = false;
+
+        bool operator==(const BorderPathKey &other) const;
+    } borderPathKey;
+    QPainterPath borderPathCache;
+    // 路径每次重新生成时增加，用于判断绘制的图片是否需要更新
+    quint64 borderPathSerial = 0;
+
+    // 填充背景和描边后的图片，重绘时直接使用
+    QPixmap borderPixmap;
+    quint64 borderPixmapSerial = 0;
+    QColor borderPixmapBackground;
+    QColor borderPixmapBorderColor;
+    int borderPixmapBorderWidth = 0;
 };
 
 DWIDGET_END_NAMESPACE
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021 ~ 2021 Deepin Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DFLOWCONTAINER_P_H
+#define DFLOWCONTAINER_P_H
+
+#include "dflowcontainer.h"
+
+#include <DObjectPrivate>
+
+#include <QHash>
+#include <QVector>
+
+DWIDGET_BEGIN_NAMESPACE
+
+class DFlowContainerPrivate : public DCORE_NAMESPACE::DObjectPrivate
+{
+public:
+    DFlowContainerPrivate(DFlowContainer *qq);
+
+    void init();
+    void doLayout();
+    void updateScrollBar();
+    void updateVisibleItems();
+    void recycleAll();
+    int lineAt(int y) const;
+
+    int count = 0;
+    QSize itemSize = QSize(64, 64);
+    int horizontalSpacing = 10;
+    int verticalSpacing = 10;
+
+    DFlowContainer::SizeHintFunction sizeHintFunction;
+    DFlowContainer::CreateFunction createFunction;
+    DFlowContainer::BindFunction bindFunction;
+
+    // 所有元素的位置，以及每一行的第一个元素和行的范围
+    QVector<QRect> geometries;
+    QVector<int> lineFirstIndex;
+    QVector<int> lineTop;
+    QVector<int> lineBottom;
+    int contentHeight = 0;
+    int layoutWidth = -1;
+    bool layoutDirty = true;
+
+    // 只有在可见区域内的元素才会拥有控件，移出可见区域的控件会被回收复用
+    QHash<int, QWidget *> visibleWidgets;
+    QList<QWidget *> recycledWidgets;
+
+    D_DECLARE_PUBLIC(DFlowContainer)
+};
+
+DWIDGET_END_NAMESPACE
+
+#endif // DFLOWCONTAINER_P_H
@@ -22,17 +22,34 @@
 
 #include <DObjectPrivate>
 
+#include <QHash>
+#include <QVector>
+
 class QLayoutItem;
 
 DWIDGET_BEGIN_NAMESPACE
 
 class DFlowLayoutPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
 {
+public:
+    static QSize horizontalFlow(const QRect &rect, const QRect &effectiveRect, int bottomMargin,
+                                const QVector<QSize> &sizes, int horizontalSpacing, int verticalSpacing,
+                                Qt::LayoutDirection direction, QVector<QRect> *geometries);
+
+private:
     DFlowLayoutPrivate(DFlowLayout *qq);
 
     QSize doLayout(const QRect &rect, bool testOnly) const;
+    const QVector<QSize> &itemSizeHints() const;
+    QSize uniformLayoutSize(const QRect &rect, const QRect &effectiveRect) const;
+    void clearCache();
 
     QList<QLayoutItem*> itemList;
+    // 元素的 sizeHint 缓存，在 DFlowLayout::invalidate 时清理
+    mutable QVector<QSize> itemSizeHintCache;
+    mutable bool itemSizeHintsValid = false;
+    mutable bool uniformItemSize = false;
+    mutable QHash<int, int> heightForWidthCache;
     int horizontalSpacing = 0;
     int verticalSpacing = 0;
     mutable QSize sizeHint;
@@ -27,6 +27,8 @@
 
 #include <DObjectPrivate>
 
+#include <QStyleOptionFrame>
+
 DWIDGET_BEGIN_NAMESPACE
 
 
@@ -34,8 +36,15 @@ class DFramePrivate : public DCORE_NAMESPACE::DObjectPrivate
 {
 public:
     DFramePrivate(DFrame *qq);
+
+    bool drawCachedFrame(QPainter *pa, const QStyleOptionFrame &opt, const QRegion &dirtyRegion);
+
     bool frameRounded;
     DPalette::ColorType backType;
+    bool frameCacheEnabled = false;
+    // 缓存的边框图片中心的颜色，用于只刷新内容区域时直接填充背景
+    QString frameCacheKey;
+    QColor frameCenterColor;
 
     D_DECLARE_PUBLIC(DFrame)
 };
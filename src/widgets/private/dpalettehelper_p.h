@@ -12,7 +12,21 @@ class DPaletteHelperPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
 public:
     DPaletteHelperPrivate(DPaletteHelper *qq);
 
-    QHash<const QWidget *, DPalette> paletteCache;
+    struct CacheEntry {
+        DPalette palette;
+        // 以下数据用于校验缓存是否有效
+        const QWidget *parent = nullptr;
+        qint64 paletteKey = 0;
+        quint64 generation = 0;
+        // 通过 DPaletteHelper::setPalette 设置的调色板，一直有效
+        bool fixed = false;
+    };
+
+    const DPalette &cachedPalette(const QWidget *widget);
+    void invalidate();
+
+    QHash<const QWidget *, CacheEntry> paletteCache;
+    quint64 generation = 1;
 
     D_DECLARE_PUBLIC(DPaletteHelper)
 };
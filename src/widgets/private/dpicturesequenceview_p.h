@@ -23,8 +23,15 @@
 #include <DObjectPrivate>
 
 #include <QList>
-#include <QGraphicsScene>
-#include <QTimer>
+#include <QMap>
+#include <QFuture>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QPixmap>
+
+QT_BEGIN_NAMESPACE
+class QImageReader;
+QT_END_NAMESPACE
 
 DWIDGET_BEGIN_NAMESPACE
 
@@ -38,8 +45,20 @@ public:
 
     void init();
     void play();
+    void stopClock();
+    QRect frameRect() const;
+    void setCurrentFrame(const QPixmap &pixmap);
 
     QPixmap loadPixmap(const QString &path);
+    static QImage loadImage(const QString &path, qreal devicePixelRatio);
+
+    void clearSequence();
+    bool isStreaming() const;
+    int frameCount() const;
+    void startStreaming();
+    void requestFrames();
+    void showStreamingFrame(const QImage &image);
+    void refreshStreamingPicture();
 
 public:
     void _q_refreshPicture();
@@ -48,9 +67,26 @@ public:
     int lastItemPos = 0;
     bool singleShot = false;
 
-    QGraphicsScene *scene;
-    QTimer *refreshTimer;
-    QList<QGraphicsPixmapItem*> pictureItemList;
+    int interval = 33;
+    bool playing = false;
+
+    // 不再使用 QGraphicsScene 中的图元，直接在 viewport 上绘制当前帧
+    QList<QPixmap> frames;
+    QPixmap currentFrame;
+    QSize sequenceSize;
+
+    // 流式播放时只解码播放位置之后的少量帧，已播放的帧随即丢弃
+    bool streaming = false;
+    int streamingBufferSize = 4;
+    bool streamingAutoScale = false;
+    QStringList streamingSources;
+    QString animatedFileName;
+    QSharedPointer<QImageReader> animationReader;
+    int animationFrameCount = 0;
+    int nextRequestFrame = 0;
+    QMap<int, QFuture<QImage>> pendingFrames;
+    // 单线程解码，保证动图文件的帧按顺序读取
+    QThreadPool decodePool;
 };
 
 DWIDGET_END_NAMESPACE
@@ -31,6 +31,7 @@
 #include <QGraphicsView>
 #include <QWheelEvent>
 #include <QPicture>
+#include <QTimer>
 #include <qmath.h>
 
 DWIDGET_BEGIN_NAMESPACE
@@ -44,6 +45,8 @@ DWIDGET_BEGIN_NAMESPACE
 #define PREVIEW_WATER_COUNT_SPACE 10
 #define NUMBERUP_SCALE_RATIO 1.05
 #define NUMBERUP_SPACE_SCALE_RATIO 0.05
+#define PREVIEW_PREFETCH_PAGES 2
+#define PREVIEW_PREFETCH_DELAY 200
 
 class GraphicsView : public QGraphicsView
 {
@@ -97,8 +100,18 @@ public:
         brect = QRectF(QPointF(0, 0), QSizeF(rect.size()));
     }
 
+    void setPagePicture(const QPicture *picture)
+    {
+        if (pagePicture == picture)
+            return;
+
+        pagePicture = picture;
+        updateGrayContent();
+    }
+
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *item, QWidget *widget) override;
     void updateGrayContent();
+    void releaseGrayContent();
     void drawNumberUpPictures(QPainter *painter);
 
 protected:
@@ -110,6 +123,7 @@ private:
     QRect pageRect;
     QRectF brect;
     QPicture grayPicture;
+    bool grayContentDirty = true;
 };
 
 class WaterMark : public QGraphicsItem
@@ -208,6 +222,9 @@ private:
     QFont font;
     QColor color;
     qreal numberUpScale = 1;
+    // 平铺的文字图块或缩放后的图片水印
+    QImage tileCache;
+    QString tileCacheKey;
 
     QPolygonF brectPolygon;
     QPolygonF twoPolygon;
@@ -240,10 +257,19 @@ public:
         return pageNum;
     }
 
+    inline void setPagePicture(const QPicture *picture)
+    {
+        pagePicture = picture;
+        content->setPagePicture(picture);
+    }
+
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *item, QWidget *widget) override;
 
     void setVisible(bool isVisible);
 
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
+
 private:
     int pageNum;
     const QPicture *pagePicture;
@@ -287,6 +313,11 @@ public:
     void printByCups();
 
     void generatePreviewPicture();// 发送requestPaint信号，重新获取原文档数据
+    bool recordPictures(const QVector<int> &pageNumbers);// 异步模式下录制指定页面并放入缓存
+    void updatePagePictures();// 页面项指向当前的 pictures，缓存中的页面被释放前必须调用
+    void evictPictures();// 释放当前页附近以外的缓存页面
+    void schedulePrefetch();// 空闲时预先录制翻页方向上的页面
+    void prefetchPictures();
     void calculateNumberUpPage();// 重绘页面，当拼版数改变、纸张大小等操作时必须调用，
     void calculateNumberPagePosition();// 计算每小页面的显示位置
 
@@ -330,6 +361,15 @@ public:
     QVector<int> previewPages;
     bool asynPreviewNeedUpdate;
     int asynPreviewTotalPage;
+    // 异步预览时已录制的页面（原文档页码 -> 页面），只保留当前页前后 PREVIEW_PREFETCH_PAGES 页
+    QMap<int, QPicture> pictureCache;
+    bool pictureCacheEnabled = true;
+    // generateWaterMarkImage 生成的水印图片及其对应的水印参数
+    mutable QByteArray waterMarkImageKey;
+    mutable QImage waterMarkImageCache;
+    // 翻页停止一段时间后再预取，避免和当前页的绘制抢占主线程
+    QTimer *prefetchTimer = nullptr;
+    int navigationStep = 1; // 最近一次翻页的方向
     int pageCopyCount = 0;
     bool isFirstPage;
 
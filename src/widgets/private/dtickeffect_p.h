@@ -40,6 +40,7 @@ public:
     int fixPixel;
     QVariantAnimation *runAnimation;
     QWidget *content;
+    bool pausedByHide = false;
 
     D_DECLARE_PUBLIC(DTickEffect)
 };
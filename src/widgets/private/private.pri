@@ -54,7 +54,10 @@ HEADERS += \
     $$PWD/dsearchcombobox_p.h \
     $$PWD/dprintpreviewdialog_p.h \
     $$PWD/dprintpreviewwidget_p.h \
-    $$PWD/dpalettehelper_p.h
+    $$PWD/dpalettehelper_p.h \
+    $$PWD/danimationclock_p.h \
+    $$PWD/dflowcontainer_p.h
 
 SOURCES += \
-    $$PWD/dthemehelper.cpp
+    $$PWD/dthemehelper.cpp \
+    $$PWD/danimationclock.cpp
@@ -27,9 +27,11 @@
 #include <QScroller>
 #include <QMouseEvent>
 #include <QFormLayout>
+#include <QTimer>
 
 #include <DSettings>
 #include <DSettingsGroup>
+#include <DSettingsOption>
 #include <DSuggestButton>
 #include <DPushButton>
 #include <DFontSizeManager>
@@ -41,6 +43,16 @@
 
 DWIDGET_BEGIN_NAMESPACE
 
+// 每个子组的选项控件在第一次滚动到可见区域时才创建，创建前使用估算的高度占位
+struct PendingGroup
+{
+    QPointer<DBackgroundGroup> group;
+    QVBoxLayout *layout = nullptr;
+    QList<QPointer<DTK_CORE_NAMESPACE::DSettingsOption>> options;
+    QString subGroupKey;
+    int contentRow = 0;
+};
+
 class ContentPrivate
 {
 public:
@@ -50,6 +62,11 @@ public:
         widgetFactory = new DSettingsWidgetFactory(parent);
     }
 
+    void createOptions(const PendingGroup &pending);
+    void loadPendingGroups(int before = -1);
+    void loadVisibleGroups();
+    void scheduleLoadVisibleGroups();
+
     QScrollArea *contentArea = nullptr;
     QWidget *contentFrame = nullptr;
     QVBoxLayout *contentLayout = nullptr;
@@ -57,12 +74,148 @@ public:
     QMap<QString, QWidget *> titles = {};
     QList<QWidget *> sortTitles = {};
 
+    QByteArray translateContext;
+    QList<PendingGroup> pendingGroups;
+    // 单个选项行的估算高度，每创建一组选项后根据实际高度更新
+    int optionHeightHint = 48;
+    bool loadScheduled = false;
+
     DSettingsWidgetFactory *widgetFactory = nullptr;
 
     Content *q_ptr;
     Q_DECLARE_PUBLIC(Content)
 };
 
+void ContentPrivate::createOptions(const PendingGroup &pending)
+{
+    if (!pending.group)
+        return;
+
+    QVBoxLayout *bgGpLayout = pending.layout;
+
+    for (auto option : pending.options) {
+        if (!option || option->isHidden()) {
+            continue;
+        }
+
+        QWidget *wrapperWidget = new QWidget();
+        QHBoxLayout *hLay = new QHBoxLayout(wrapperWidget);
+        hLay->setContentsMargins(10, 6, 10, 6);
+        auto widget = widgetFactory->createItem(translateContext, option);
+
+        // 先尝试创建item
+        if (widget.first || widget.second) {
+            if (QLabel *label = qobject_cast<QLabel *>(widget.first)) {
+                if (widget.second)
+                    label->setBuddy(widget.second);
+            }
+
+            if (widget.first) {
+                hLay->addWidget(widget.first, 2);
+            }
+            if (widget.second) {
+                hLay->addWidget(widget.second, 3);
+            }
+            wrapperWidget->setAccessibleName(QString("CustomWidgetAtContentRow%1BackgroundRow%2").arg(pending.contentRow).arg(bgGpLayout->count()));
+
+            if (widget.first) {
+                widget.first->setProperty("_d_dtk_group_key", pending.subGroupKey);
+            }
+
+            if (widget.second) {
+                widget.second->setProperty("_d_dtk_group_key", pending.subGroupKey);
+            }
+        } else {
+            QWidget *widget = widgetFactory->createWidget(translateContext, option);
+
+            if (widget) {
+                widget->setProperty("_d_dtk_group_key", pending.subGroupKey);
+                hLay->addWidget(widget);
+                wrapperWidget->setAccessibleName(QString("DefaultWidgetAtContentRow%1BackgroundRow%2").arg(pending.contentRow).arg(bgGpLayout->count()));
+            }
+        }
+        bgGpLayout->addWidget(wrapperWidget);
+    }
+
+    pending.group->setMinimumHeight(0);
+
+    if (bgGpLayout->count() > 0) {
+        int height = pending.group->sizeHint().height();
+        if (height > 0)
+            optionHeightHint = qMax(1, height / bgGpLayout->count());
+    }
+}
+
+/*!
+ * \~chinese \brief ContentPrivate::loadPendingGroups 创建在布局中位于 \a before 之前的所有子组，
+ * \~chinese 为 -1 时创建全部子组
+ */
+void ContentPrivate::loadPendingGroups(int before)
+{
+    for (auto it = pendingGroups.begin(); it != pendingGroups.end();) {
+        if (before >= 0 && contentLayout->indexOf(it->group.data()) >= before) {
+            ++it;
+            continue;
+        }
+
+        PendingGroup pending = *it;
+        it = pendingGroups.erase(it);
+        createOptions(pending);
+    }
+
+    contentLayout->activate();
+}
+
+void ContentPrivate::loadVisibleGroups()
+{
+    if (pendingGroups.isEmpty() || !contentArea->isVisible())
+        return;
+
+    contentLayout->activate();
+
+    // 预先创建下一屏的内容，保证滚动时不会看到占位区域
+    const int viewHeight = contentArea->viewport()->height();
+    const int top = contentArea->verticalScrollBar()->value();
+    const int bottom = top + viewHeight * 2;
+    bool changed = false;
+
+    for (auto it = pendingGroups.begin(); it != pendingGroups.end();) {
+        DBackgroundGroup *group = it->group;
+
+        if (!group) {
+            it = pendingGroups.erase(it);
+            continue;
+        }
+
+        if (!group->isVisibleTo(contentFrame)
+                || group->geometry().bottom() < top || group->y() > bottom) {
+            ++it;
+            continue;
+        }
+
+        PendingGroup pending = *it;
+        it = pendingGroups.erase(it);
+        createOptions(pending);
+        changed = true;
+    }
+
+    // 实际高度与估算高度不同时，后面的子组位置会发生变化，需要再检查一次
+    if (changed)
+        scheduleLoadVisibleGroups();
+}
+
+void ContentPrivate::scheduleLoadVisibleGroups()
+{
+    if (loadScheduled || pendingGroups.isEmpty())
+        return;
+
+    loadScheduled = true;
+    QTimer::singleShot(0, q_ptr, [this] {
+        loadScheduled = false;
+        loadVisibleGroups();
+    });
+}
+
 Content::Content(QWidget *parent)
     : QWidget(parent)
     , d_ptr(new ContentPrivate(this))
@@ -105,6 +258,8 @@ Content::Content(QWidget *parent)
     this, [ = ](int value) {
         Q_D(Content);
 
+        d->loadVisibleGroups();
+
         // 当前显示的Title才参与滚动条的计算
         QList<QWidget *> visableSortTitles;
         for (auto idx = 0; idx < d->sortTitles.length(); ++idx) {
@@ -195,6 +350,9 @@ void Content::setGroupVisible(const QString &key, bool visible)
             }
         }
     }
+
+    if (visible)
+        d->scheduleLoadVisibleGroups();
 }
 
 void Content::onScrollToGroup(const QString &key)
@@ -205,6 +363,9 @@ void Content::onScrollToGroup(const QString &key)
 
     auto title = d->titles.value(key);
 
+    // 目标之前的子组需要先创建，否则占位的估算高度会导致滚动位置不准确
+    d->loadPendingGroups(d->contentLayout->indexOf(title));
+
     this->blockSignals(true);
     d->contentArea->verticalScrollBar()->setValue(title->y());
     this->blockSignals(false);
@@ -218,6 +379,8 @@ void Content::updateSettings(const QByteArray &translateContext, QPointer<DTK_CO
     QString current_groupKey;
     QString current_subGroupKey;
 
+    d->translateContext = translateContext;
+
     for (auto groupKey : settings->groupKeys()) {
         current_groupKey = groupKey;
 
@@ -282,49 +445,19 @@ void Content::updateSettings(const QByteArray &translateContext, QPointer<DTK_CO
             bgGroup->setBackgroundRole(QPalette::Window);
             d->contentLayout->addWidget(bgGroup);
 
-            for (auto option : subgroup->childOptions()) {
-                if (option->isHidden()) {
-                    continue;
-                }
-
-                QWidget *wrapperWidget = new QWidget();
-                QHBoxLayout *hLay = new QHBoxLayout(wrapperWidget);
-                hLay->setContentsMargins(10, 6, 10, 6);
-                auto widget = d->widgetFactory->createItem(translateContext, option);
-
-                // 先尝试创建item
-                if (widget.first || widget.second) {
-                    if (QLabel *label = qobject_cast<QLabel *>(widget.first)) {
-                        if (widget.second)
-                            label->setBuddy(widget.second);
-                    }
-
-                    if (widget.first) {
-                        hLay->addWidget(widget.first, 2);
-                    }
-                    if (widget.second) {
-                        hLay->addWidget(widget.second, 3);
-                    }
-                    wrapperWidget->setAccessibleName(QString("CustomWidgetAtContentRow%1BackgroundRow%2").arg(d->contentLayout->count()).arg(bgGpLayout->count()));
-
-                    if (widget.first) {
-                        widget.first->setProperty("_d_dtk_group_key", current_subGroupKey);
-                    }
-
-                    if (widget.second) {
-                        widget.second->setProperty("_d_dtk_group_key", current_subGroupKey);
-                    }
-                } else {
-                    QWidget *widget = d->widgetFactory->createWidget(translateContext, option);
+            PendingGroup pending;
+            pending.group = bgGroup;
+            pending.layout = bgGpLayout;
+            pending.subGroupKey = current_subGroupKey;
+            pending.contentRow = d->contentLayout->count();
 
-                    if (widget) {
-                        widget->setProperty("_d_dtk_group_key", current_subGroupKey);
-                        hLay->addWidget(widget);
-                        wrapperWidget->setAccessibleName(QString("DefaultWidgetAtContentRow%1BackgroundRow%2").arg(d->contentLayout->count()).arg(bgGpLayout->count()));
-                    }
-                }
-                bgGpLayout->addWidget(wrapperWidget);
+            for (auto option : subgroup->childOptions()) {
+                if (!option->isHidden())
+                    pending.options << option;
             }
+
+            bgGroup->setMinimumHeight(pending.options.count() * d->optionHeightHint);
+            d->pendingGroups << pending;
         }
         QSpacerItem *spaceItem = new QSpacerItem(0, 20,QSizePolicy::Minimum,QSizePolicy::Expanding);
         d->contentLayout->addItem(spaceItem);
@@ -348,6 +481,8 @@ void Content::updateSettings(const QByteArray &translateContext, QPointer<DTK_CO
     this, [ = ]() {
         settings->reset();
     });
+
+    d->scheduleLoadVisibleGroups();
 }
 
 void Content::mouseMoveEvent(QMouseEvent *event)
@@ -366,8 +501,17 @@ void Content::resizeEvent(QResizeEvent *event)
 {
     Q_D(Content);
     d->contentFrame->setMaximumWidth(d->contentArea->width());
+    d->scheduleLoadVisibleGroups();
 
     return QWidget::resizeEvent(event);
 }
 
+void Content::showEvent(QShowEvent *event)
+{
+    Q_D(Content);
+    d->scheduleLoadVisibleGroups();
+
+    return QWidget::showEvent(event);
+}
+
 DWIDGET_END_NAMESPACE
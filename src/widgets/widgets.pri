@@ -116,7 +116,8 @@ HEADERS += $$PWD/dslider.h\
     $$PWD/dsearchcombobox.h \
     $$PWD/dprintpreviewwidget.h \
     $$PWD/dprintpickcolorwidget.h \
-    $$PWD/dpalettehelper.h
+    $$PWD/dpalettehelper.h \
+    $$PWD/dflowcontainer.h
 
 SOURCES += $$PWD/dslider.cpp \
     $$PWD/dbackgroundgroup.cpp \
@@ -203,7 +204,8 @@ SOURCES += $$PWD/dslider.cpp \
     $$PWD/dsearchcombobox.cpp \
     $$PWD/dprintpreviewwidget.cpp \
     $$PWD/dprintpickcolorwidget.cpp \
-    $$PWD/dpalettehelper.cpp
+    $$PWD/dpalettehelper.cpp \
+    $$PWD/dflowcontainer.cpp
 
 RESOURCES += \
     $$PWD/icons.qrc \
@@ -328,6 +330,7 @@ includes.files += \
     $$PWD/DTreeView \
     $$PWD/DUndoView \
     $$PWD/DWhatsThis \
+    $$PWD/DFlowContainer \
     $$PWD/DWizard \
     $$PWD/DWizardPage \
     $$PWD/DDialog \
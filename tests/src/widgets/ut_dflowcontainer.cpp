@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021 ~ 2021 Deepin Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <QTest>
+#include <QScrollBar>
+
+#include "dflowcontainer.h"
+
+DWIDGET_USE_NAMESPACE
+
+class ut_DFlowContainer : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+    DFlowContainer *container = nullptr;
+    int createCount = 0;
+};
+
+void ut_DFlowContainer::SetUp()
+{
+    container = new DFlowContainer;
+    container->setFrameShape(QFrame::NoFrame);
+    container->setItemSize(QSize(50, 50));
+    container->setSpacing(10);
+    container->setCreateFunction([this](QWidget *parent) {
+        ++createCount;
+        return new QWidget(parent);
+    });
+    container->setBindFunction([](QWidget *widget, int index) {
+        widget->setProperty("index", index);
+    });
+    container->resize(300, 200);
+    container->show();
+}
+
+void ut_DFlowContainer::TearDown()
+{
+    delete container;
+}
+
+TEST_F(ut_DFlowContainer, testGeometry)
+{
+    container->setCount(100);
+
+    // 每行放置的元素数量取决于 viewport 的宽度
+    const int width = container->viewport()->width();
+    const int perLine = (width - 1 - 50) / 60 + 1;
+
+    ASSERT_EQ(container->itemRect(0), QRect(0, 0, 50, 50));
+    ASSERT_EQ(container->itemRect(1), QRect(60, 0, 50, 50));
+    ASSERT_EQ(container->itemRect(perLine), QRect(0, 60, 50, 50));
+    ASSERT_EQ(container->indexAt(QPoint(65, 5)), 1);
+    ASSERT_EQ(container->indexAt(QPoint(55, 5)), -1);
+}
+
+TEST_F(ut_DFlowContainer, testRecycle)
+{
+    container->setCount(50000);
+
+    const int created = createCount;
+    ASSERT_GT(created, 0);
+    ASSERT_LT(created, 100);
+    ASSERT_TRUE(container->itemWidget(0));
+    ASSERT_EQ(container->itemWidget(0)->property("index").toInt(), 0);
+
+    QScrollBar *bar = container->verticalScrollBar();
+    bar->setValue(bar->maximum() / 2);
+
+    // 滚动后复用已有的控件，不会再创建新的控件
+    ASSERT_FALSE(container->itemWidget(0));
+    ASSERT_LE(createCount, created + container->viewport()->width() / 60 + 1);
+
+    const int index = container->indexAt(QPoint(5, 5));
+    ASSERT_GE(index, 0);
+    ASSERT_TRUE(container->itemWidget(index));
+    ASSERT_EQ(container->itemWidget(index)->property("index").toInt(), index);
+}
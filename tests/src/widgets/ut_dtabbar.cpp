@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021 ~ 2021 Deepin Technology Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <QTest>
+#include <QProxyStyle>
+#include <QStyleOptionTab>
+#include <QTabBar>
+
+#include "dtabbar.h"
+
+DWIDGET_USE_NAMESPACE
+
+// 记录计算了哪些标签的大小
+class TabSizeStyle : public QProxyStyle
+{
+public:
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option,
+                           const QSize &size, const QWidget *widget) const override
+    {
+        if (type == CT_TabBarTab) {
+            if (const QStyleOptionTab *tab = qstyleoption_cast<const QStyleOptionTab *>(option))
+                measuredTabs << tab->text;
+        }
+
+        return QProxyStyle::sizeFromContents(type, option, size, widget);
+    }
+
+    mutable QStringList measuredTabs;
+};
+
+class ut_DTabBar : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+    DTabBar *tabBar = nullptr;
+    QTabBar *bar = nullptr;
+    TabSizeStyle *style = nullptr;
+};
+
+void ut_DTabBar::SetUp()
+{
+    tabBar = new DTabBar;
+    bar = tabBar->findChild<QTabBar *>();
+    style = new TabSizeStyle;
+    bar->setStyle(style);
+}
+
+void ut_DTabBar::TearDown()
+{
+    delete tabBar;
+    delete style;
+}
+
+TEST_F(ut_DTabBar, testTabSizeHintCache)
+{
+    ASSERT_TRUE(bar);
+
+    for (int i = 0; i < 100; ++i)
+        tabBar->addTab(QString("tab %1").arg(i));
+
+    // tabRect 会在需要时重新布局所有标签
+    bar->tabRect(0);
+    ASSERT_FALSE(style->measuredTabs.isEmpty());
+
+    style->measuredTabs.clear();
+    tabBar->insertTab(50, "inserted tab");
+    bar->tabRect(0);
+
+    ASSERT_FALSE(style->measuredTabs.isEmpty());
+    ASSERT_EQ(style->measuredTabs.toSet(), QSet<QString>{"inserted tab"});
+
+    // 没有变化的标签再次布局时不需要重新计算
+    style->measuredTabs.clear();
+    tabBar->setTabText(10, "renamed tab");
+    bar->tabRect(0);
+
+    ASSERT_EQ(style->measuredTabs.toSet(), QSet<QString>{"renamed tab"});
+}
@@ -17,4 +17,6 @@ SOURCES += \
     $$PWD/ut_dswitchbutton.cpp \
     $$PWD/ut_dwarningbutton.cpp \
     $$PWD/ut_dsimplelistview.cpp \
-    $$PWD/ut_dkeysequenceedit.cpp
+    $$PWD/ut_dkeysequenceedit.cpp \
+    $$PWD/ut_dflowcontainer.cpp \
+    $$PWD/ut_dtabbar.cpp
@@ -1316,6 +1316,66 @@ TEST_F(ut_DPrintPreviewWidgetPrivate, testPageItem)
     ASSERT_TRUE(content->imageGrayscale(&origin).isGrayscale());
 }
 
+TEST_F(ut_DPrintPreviewWidgetPrivate, testImageGrayscale)
+{
+    ContentItem content(nullptr, QRect(0, 0, 10, 10));
+
+    const QImage::Format formats[] = {
+        QImage::Format_ARGB32,
+        QImage::Format_ARGB32_Premultiplied,
+        QImage::Format_RGB32,
+    };
+    // 宽度不是 4 和 8 的倍数时会走到逐像素处理的尾部，700x600 的图片会分块并行处理
+    const QSize sizes[] = {
+        QSize(1, 1),
+        QSize(13, 7),
+        QSize(1003, 5),
+        QSize(700, 600),
+    };
+
+    quint32 seed = 1;
+    for (QImage::Format format : formats) {
+        for (const QSize &size : sizes) {
+            QImage origin(size, format);
+            for (int y = 0; y < origin.height(); ++y) {
+                QRgb *line = reinterpret_cast<QRgb *>(origin.scanLine(y));
+                for (int x = 0; x < origin.width(); ++x) {
+                    seed = seed * 1103515245 + 12345;
+                    int a = (seed >> 24) & 0xff;
+                    int r = (seed >> 16) & 0xff;
+                    int g = (seed >> 8) & 0xff;
+                    int b = seed & 0xff;
+
+                    if (format == QImage::Format_RGB32) {
+                        a = 0xff;
+                    } else if (format == QImage::Format_ARGB32_Premultiplied) {
+                        r = r * a / 0xff;
+                        g = g * a / 0xff;
+                        b = b * a / 0xff;
+                    }
+
+                    line[x] = qRgba(r, g, b, a);
+                }
+            }
+
+            const QImage gray = content.imageGrayscale(&origin);
+            ASSERT_EQ(gray.format(), format);
+            ASSERT_EQ(gray.size(), size);
+
+            for (int y = 0; y < origin.height(); ++y) {
+                const QRgb *src = reinterpret_cast<const QRgb *>(origin.constScanLine(y));
+                const QRgb *dst = reinterpret_cast<const QRgb *>(gray.constScanLine(y));
+                for (int x = 0; x < origin.width(); ++x) {
+                    const int val = qGray(src[x]);
+                    ASSERT_EQ(dst[x], qRgba(val, val, val, qAlpha(src[x])))
+                            << "format " << format << " size " << size.width() << "x" << size.height()
+                            << " pixel " << x << "," << y;
+                }
+            }
+        }
+    }
+}
+
 TEST_F(ut_DPrintPreviewWidgetPrivate, graphicsViewEvent)
 {
     // 测试GraphicsView类中的鼠标事件是否正常